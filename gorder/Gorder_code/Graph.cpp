@@ -11,6 +11,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 
 #include "Graph.h"
+#include "transpose.h"
 
 #ifdef __GNUC__
 #define likely(cond) __builtin_expect(!!(cond), 1)
@@ -89,6 +90,10 @@ void Graph::readGraph(const string& fullname) {
 	vsize++;
 
 	fclose(fp);
+	if(edgenum>numeric_limits<EdgeId>::max()){
+		cout << "too many edges for 32-bit offsets, rebuild with LARGE=1" << endl;
+		quit();
+	}
 	graph.resize(vsize+1);
 	for(long long i=0; i<edges.size(); i++){
 		graph[edges[i].first].outdegree++;
@@ -122,17 +127,7 @@ void Graph::readGraph(const string& fullname) {
 
 	vector< pair<int, int> >().swap(edges);
 #ifndef Release	
-	vector<int> inpos(vsize);
-	for(int i=0; i<vsize; i++){
-		inpos[i]=graph[i].instart;
-	}
-	inedge.resize(edgenum);
-	for(int u=0; u<vsize; u++){
-		for(int j=graph[u].outstart; j<graph[u].outstart+graph[u].outdegree; j++){
-			inedge[inpos[outedge[j]]]=u;
-			inpos[outedge[j]]++;
-		}
-	}
+	BuildInEdges();
 #endif
 
 	cout << "vsize: " << vsize << endl;
@@ -141,8 +136,44 @@ void Graph::readGraph(const string& fullname) {
 	graph[vsize].instart=edgenum;
 }
 
+void Graph::readBinaryGraph(const string& fullname) {
+	bcsrFile file;
+	if(open_bcsr(fullname.c_str(), &file, false)<0){
+		cout << "Fail to open " << fullname << endl;
+		quit();
+	}
+	if(file.header.offsetBytes!=sizeof(uint32_t) && file.header.offsetBytes!=sizeof(uint64_t)){
+		cout << "unsupported offset width in " << fullname << endl;
+		quit();
+	}
+	const uint32_t* vi32=(const uint32_t*)file.section[BCSR_OUT_VI];
+	const uint64_t* vi64=(const uint64_t*)file.section[BCSR_OUT_VI];
+	const uint32_t* ei=(const uint32_t*)file.section[BCSR_OUT_EI];
+	const bool wide=(file.header.offsetBytes==sizeof(uint64_t));
+
+	if(wide)
+		readCSR<uint32_t, uint64_t>(file.header.numVertex, vi64, ei);
+	else
+		readCSR<uint32_t, uint32_t>(file.header.numVertex, vi32, ei);
+	close_bcsr(&file);
+}
+
+// inedge from outedge with the parallel transpose, the in-lists come out sorted
+// and match graph[].instart
+void Graph::BuildInEdges(){
+	vector<EdgeId> inpos(vsize+1);
+	inedge.resize(edgenum);
+	parallelTranspose(vsize, [&](int u){ return (u==vsize) ? (EdgeId)edgenum : graph[u].outstart; },
+		outedge.data(), vsize, inpos.data(), inedge.data());
+}
+
 void Graph::Transform(){
 	vector<int> order;
+	Transform(order);
+}
+
+// relabels the graph by its RCM order, order[i] is the new id of vertex i
+void Graph::Transform(vector<int>& order){
 	RCMOrder(order);
 	if(order.size()!=vsize){
 		cout << "order.size()!=vsize" << endl;
@@ -157,7 +188,7 @@ void Graph::Transform(){
 	vector< pair<int, int> > edges;
 	edges.reserve(edgenum);
 	for(int i=0; i<vsize; i++){
-		for(int j=graph[i].outstart, limit=graph[i+1].outstart; j<limit; j++)
+		for(EdgeId j=graph[i].outstart, limit=graph[i+1].outstart; j<limit; j++)
 			edges.push_back(make_pair(order[i], order[outedge[j]]));
 	}
 	if(edges.size()!=edgenum){
@@ -168,7 +199,7 @@ void Graph::Transform(){
 	for(int i=0; i<vsize; i++){
 		graph[i].outdegree=graph[i].indegree=0;
 	}
-	for(int i=0; i<edges.size(); i++){
+	for(long long i=0; i<edges.size(); i++){
 		graph[edges[i].first].outdegree++;
 		graph[edges[i].second].indegree++;
 	}
@@ -201,23 +232,13 @@ void Graph::Transform(){
 		outedge[i]=edges[i].second;
 	}
 	vector< pair<int, int> >().swap(edges);
-	vector<int> inpos(vsize);
-	for(int i=0; i<vsize; i++){
-		inpos[i]=graph[i].instart;
-	}
-	inedge.resize(edgenum);
-	for(int u=0; u<vsize; u++){
-		for(int j=graph[u].outstart; j<graph[u].outstart+graph[u].outdegree; j++){
-			inedge[inpos[outedge[j]]]=u;
-			inpos[outedge[j]]++;
-		}
-	}
+	BuildInEdges();
 }
 
 
 void Graph::writeGraph(ostream& out){
 	for(int u=0; u<vsize; u++){
-		for(int j=graph[u].outstart; j<graph[u].outdegree+graph[u].outstart; j++){
+		for(EdgeId j=graph[u].outstart; j<graph[u].outdegree+graph[u].outstart; j++){
 			int v=outedge[j];
 			out << u << '\t' << v << endl;
 		}
@@ -235,7 +256,7 @@ void Graph::PrintReOrderedGraph(const vector<int>& order){
 	for(int i=0; i<vsize; i++){
 		u=order[i];
 		ReOrderedGraph[u].reserve(graph[i+1].outstart-graph[i].outstart);
-		for(int j=graph[i].outstart; j<graph[i].outstart+graph[i].outdegree; j++){
+		for(EdgeId j=graph[i].outstart; j<graph[i].outstart+graph[i].outdegree; j++){
 			v=order[outedge[j]];
 			ReOrderedGraph[u].push_back(v);
 		}
@@ -367,7 +388,7 @@ void Graph::GapCount(){
 	memset(gap, 0, sizeof(int)*vsize);
 
 	for(int i=0; i<vsize; i++){
-		for(int j=graph[i].outstart+1; j<graph[i].outdegree+graph[i].outstart; j++){
+		for(EdgeId j=graph[i].outstart+1; j<graph[i].outdegree+graph[i].outstart; j++){
 				gap[outedge[j]-outedge[j-1]]++;
 		}
 		gap[outedge[graph[i].outstart]]++;
@@ -391,12 +412,12 @@ double Graph::GapCost(vector<int>& order){
 	vector<int> edgelist;
 	edgelist.reserve(100000);
 	for(int i=0; i<vsize; i++){
-		for(int j=graph[i].outstart+1; j<graph[i].outdegree+graph[i].outstart; j++){
+		for(EdgeId j=graph[i].outstart+1; j<graph[i].outdegree+graph[i].outstart; j++){
 			if(outedge[j]-outedge[j-1])
 				gaplog+=log(double(outedge[j]-outedge[j-1]))/log(double(2));
 		}
 		edgelist.clear();
-		for(int j=graph[i].outstart; j<graph[i].outstart+graph[i].outdegree; j++){
+		for(EdgeId j=graph[i].outstart; j<graph[i].outstart+graph[i].outdegree; j++){
 			edgelist.push_back(order[outedge[j]]);
 		}
 		sort(edgelist.begin(), edgelist.end());
@@ -445,7 +466,7 @@ void Graph::GorderGreedy(vector<int>& retorder, int window){
 	order.push_back(tmpindex);
 	unitheap.update[tmpindex]=INT_MAX/2;
 	unitheap.DeleteElement(tmpindex);
-	for(int i=graph[tmpindex].instart, limit1=graph[tmpindex+1].instart; i<limit1; i++){
+	for(EdgeId i=graph[tmpindex].instart, limit1=graph[tmpindex+1].instart; i<limit1; i++){
 		int u=inedge[i];
 		if(graph[u].outdegree<=hugevertex){
 			if(unitheap.update[u]==0){
@@ -459,7 +480,7 @@ void Graph::GorderGreedy(vector<int>& retorder, int window){
 			}
 			
 			if(graph[u].outdegree>1)
-			for(int j=graph[u].outstart, limit2=graph[u+1].outstart; j<limit2; j++){
+			for(EdgeId j=graph[u].outstart, limit2=graph[u+1].outstart; j<limit2; j++){
 				int w=outedge[j];
 				if(unitheap.update[w]==0){
 					unitheap.IncrementKey(w);
@@ -475,7 +496,7 @@ void Graph::GorderGreedy(vector<int>& retorder, int window){
 		}
 	}
 	if(graph[tmpindex].outdegree<=hugevertex){
-		for(int i=graph[tmpindex].outstart, limit1=graph[tmpindex+1].outstart; i<limit1; i++){
+		for(EdgeId i=graph[tmpindex].outstart, limit1=graph[tmpindex+1].outstart; i<limit1; i++){
 			int w=outedge[i];
 			if(unitheap.update[w]==0){
 				unitheap.IncrementKey(w);
@@ -525,7 +546,7 @@ void Graph::GorderGreedy(vector<int>& retorder, int window){
 
 		if(popv>=0){
 			if(graph[popv].outdegree<=hugevertex){
-				for(int i=graph[popv].outstart, limit1=graph[popv+1].outstart; i<limit1; i++){
+				for(EdgeId i=graph[popv].outstart, limit1=graph[popv+1].outstart; i<limit1; i++){
 					int w=outedge[i];
 					unitheap.update[w]--;
 #ifndef Release
@@ -535,7 +556,7 @@ void Graph::GorderGreedy(vector<int>& retorder, int window){
 				}
 			}
 
-			for(int i=graph[popv].instart, limit1=graph[popv+1].instart; i<limit1; i++){
+			for(EdgeId i=graph[popv].instart, limit1=graph[popv+1].instart; i<limit1; i++){
 				int u=inedge[i];
 				if(graph[u].outdegree<=hugevertex){
 					unitheap.update[u]--;
@@ -545,7 +566,7 @@ void Graph::GorderGreedy(vector<int>& retorder, int window){
 #endif
 					if(graph[u].outdegree>1)
 					if(binary_search(outedge.data() + graph[u].outstart, outedge.data() + graph[u+1].outstart, v)==false){
-						for(int j=graph[u].outstart, limit2=graph[u+1].outstart; j<limit2; j++){
+						for(EdgeId j=graph[u].outstart, limit2=graph[u+1].outstart; j<limit2; j++){
 							int w=outedge[j];
 							unitheap.update[w]--;
 #ifndef Release
@@ -564,7 +585,7 @@ void Graph::GorderGreedy(vector<int>& retorder, int window){
 		time3=clock();
 #endif
 		if(graph[v].outdegree<=hugevertex){
-			for(int i=graph[v].outstart, limit1=graph[v+1].outstart; i<limit1; i++){
+			for(EdgeId i=graph[v].outstart, limit1=graph[v+1].outstart; i<limit1; i++){
 				int w=outedge[i];
 				if(unlikely(unitheap.update[w]==0)){
 					unitheap.IncrementKey(w);
@@ -579,7 +600,7 @@ void Graph::GorderGreedy(vector<int>& retorder, int window){
 			}
 		}
 
-		for(int i=graph[v].instart, limit1=graph[v+1].instart; i<limit1; i++){
+		for(EdgeId i=graph[v].instart, limit1=graph[v+1].instart; i<limit1; i++){
 			int u=inedge[i];
 			if(graph[u].outdegree<=hugevertex){
 				if(unlikely(unitheap.update[u]==0)){
@@ -594,7 +615,7 @@ void Graph::GorderGreedy(vector<int>& retorder, int window){
 				
 				if(popvexist[u]==false){
 					if(graph[u].outdegree>1)
-					for(int j=graph[u].outstart, limit2=graph[u+1].outstart; j<limit2; j++){
+					for(EdgeId j=graph[u].outstart, limit2=graph[u+1].outstart; j<limit2; j++){
 						int w=outedge[j];
 						if(unlikely(unitheap.update[w]==0)){
 							unitheap.IncrementKey(w);
@@ -649,6 +670,140 @@ void Graph::GorderGreedy(vector<int>& retorder, int window){
 }
 
 
+void Graph::InducedSubgraph(int first, int last, Graph& sub){
+	sub.clear();
+	sub.vsize=last-first;
+	sub.graph.resize(sub.vsize+1);
+	for(int i=first; i<last; i++){
+		Vertex& x=sub.graph[i-first];
+		x.outstart=sub.outedge.size();
+		for(EdgeId j=graph[i].outstart, limit=graph[i+1].outstart; j<limit; j++){
+			if(outedge[j]>=first && outedge[j]<last)
+				sub.outedge.push_back(outedge[j]-first);
+		}
+		x.outdegree=sub.outedge.size()-x.outstart;
+		x.instart=sub.inedge.size();
+		for(EdgeId j=graph[i].instart, limit=graph[i+1].instart; j<limit; j++){
+			if(inedge[j]>=first && inedge[j]<last)
+				sub.inedge.push_back(inedge[j]-first);
+		}
+		x.indegree=sub.inedge.size()-x.instart;
+	}
+	sub.edgenum=sub.outedge.size();
+	sub.graph[sub.vsize].outstart=sub.edgenum;
+	sub.graph[sub.vsize].instart=sub.edgenum;
+}
+
+void Graph::GorderGreedyParallel(vector<int>& retorder, int window, int numParts){
+	// contiguous id ranges (ids are in RCM order after Transform) with about
+	// the same number of edges
+	vector<int> partStart(numParts+1, vsize);
+	partStart[0]=0;
+	long long total=2*edgenum+vsize, acc=0;
+	int p=0;
+	for(int i=0; i<vsize && p+1<numParts; i++){
+		acc+=graph[i].outdegree+graph[i].indegree+1;
+		if(acc>=total*(p+1)/numParts)
+			partStart[++p]=i+1;
+	}
+	vector<int> part(vsize);
+	for(p=0; p<numParts; p++){
+		for(int i=partStart[p]; i<partStart[p+1]; i++)
+			part[i]=p;
+	}
+
+	// every partition runs the sequential greedy with its own UnitHeap
+	retorder.resize(vsize);
+	parallelFor(numParts, [&](unsigned int tid, unsigned long long first, unsigned long long last){
+		for(unsigned long long q=first; q<last; q++){
+			if(partStart[q]==partStart[q+1])
+				continue;
+			Graph sub;
+			InducedSubgraph(partStart[q], partStart[q+1], sub);
+			vector<int> suborder;
+			sub.GorderGreedy(suborder, window);
+			for(int i=0; i<sub.vsize; i++)
+				retorder[partStart[q]+i]=partStart[q]+suborder[i];
+		}
+	});
+
+	vector<int> order(vsize);
+	for(int i=0; i<vsize; i++)
+		order[retorder[i]]=i;
+
+	// boundary pass: a vertex with edges into other partitions is moved right
+	// behind the vertex it shares the highest score S(u,v) with, if that vertex
+	// lies in another partition. moved vertices are never used as anchors, and
+	// anchors (vertices with a chain attached) are never moved, so every vertex
+	// is placed exactly once
+	const int hugevertex=sqrt((double)vsize);
+	vector<int> score(vsize, 0);
+	vector<int> touched;
+	vector<int> anchor(vsize, -1), attachHead(vsize, -1), attachTail(vsize, -1), attachNext(vsize, -1);
+	int moved=0;
+	for(int k=0; k<vsize; k++){
+		int v=order[k];
+		bool boundary=false;
+		for(EdgeId j=graph[v].outstart, limit=graph[v+1].outstart; j<limit && !boundary; j++)
+			boundary=(part[outedge[j]]!=part[v]);
+		for(EdgeId j=graph[v].instart, limit=graph[v+1].instart; j<limit && !boundary; j++)
+			boundary=(part[inedge[j]]!=part[v]);
+		if(!boundary)
+			continue;
+
+		touched.clear();
+		for(EdgeId i=graph[v].instart, limit1=graph[v+1].instart; i<limit1; i++){
+			int u=inedge[i];
+			if(score[u]++==0)
+				touched.push_back(u);
+			if(graph[u].outdegree>hugevertex)
+				continue;
+			for(EdgeId j=graph[u].outstart, limit2=graph[u+1].outstart; j<limit2; j++){
+				int w=outedge[j];
+				if(w!=v && score[w]++==0)
+					touched.push_back(w);
+			}
+		}
+		for(EdgeId i=graph[v].outstart, limit1=graph[v+1].outstart; i<limit1; i++){
+			int w=outedge[i];
+			if(score[w]++==0)
+				touched.push_back(w);
+		}
+
+		int bestOwn=0, bestOther=0, best=-1;
+		for(int i=0; i<touched.size(); i++){
+			int w=touched[i];
+			if(part[w]==part[v]){
+				bestOwn=max(bestOwn, score[w]);
+			}else if(anchor[w]<0 && (score[w]>bestOther || (score[w]==bestOther && w<best))){
+				bestOther=score[w];
+				best=w;
+			}
+			score[w]=0;
+		}
+		if(best>=0 && bestOther>bestOwn && attachHead[v]<0){
+			anchor[v]=best;
+			if(attachHead[best]<0)
+				attachHead[best]=v;
+			else
+				attachNext[attachTail[best]]=v;
+			attachTail[best]=v;
+			moved++;
+		}
+	}
+
+	int pos=0;
+	for(int k=0; k<vsize; k++){
+		int w=order[k];
+		if(anchor[w]>=0)
+			continue;
+		retorder[w]=pos++;
+		for(int v=attachHead[w]; v>=0; v=attachNext[v])
+			retorder[v]=pos++;
+	}
+	cout << "parallel greedy: " << numParts << " partitions, " << moved << " boundary vertices moved" << endl;
+}
+
 void Graph::RCMOrder(vector<int>& retorder){
 	queue<int> que;
 	bool* BFSflag=new bool[vsize];
@@ -686,7 +841,7 @@ void Graph::RCMOrder(vector<int>& retorder){
 
 //				BFSflag[now]=true;
 				tmp.clear();
-				for(int it=graph[now].outstart, limit=graph[now+1].outstart; it<limit; it++){
+				for(EdgeId it=graph[now].outstart, limit=graph[now+1].outstart; it<limit; it++){
 					tmp.push_back(outedge[it]);
 				}
 				sort(tmp.begin(), tmp.end(), [&](const int& a, const int& b)->bool{
@@ -725,6 +880,28 @@ void Graph::RCMOrder(vector<int>& retorder){
 }
 
 
+// same score as LocalityScore(w) but for the graph relabeled by order,
+// without relabeling it
+unsigned long long Graph::LocalityScore(const vector<int>& order, const int w){
+	vector<int> inv(vsize);
+	for(int i=0; i<vsize; i++)
+		inv[order[i]]=i;
+	unsigned long long sum=0;
+	for(int i=0; i<vsize; i++){
+		int a=inv[i];
+		for(int j=i-1; j>=i-w && j>=0; j--){
+			int b=inv[j];
+			if(graph[a].indegree>0 && graph[b].indegree>0)
+				sum+=IntersectionSize(inedge.data()+graph[a].instart, inedge.data()+graph[b].instart, graph[a].indegree, graph[b].indegree, -1);
+			if(binary_search(inedge.data()+graph[a].instart, inedge.data()+graph[a].instart+graph[a].indegree, b))
+				sum++;
+			if(binary_search(inedge.data()+graph[b].instart, inedge.data()+graph[b].instart+graph[b].indegree, a))
+				sum++;
+		}
+	}
+	return sum;
+}
+
 unsigned long long Graph::LocalityScore(const int w){
 	unsigned long long sum=0;
 	for(int i=0; i<vsize; i++){
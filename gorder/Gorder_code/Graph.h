@@ -25,6 +25,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <utility>
 #include <cmath>
 #include <climits>
+#include <limits>
 #include <cstdlib>
 #include <ctime>
 #include <cstring>
@@ -33,17 +34,26 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include "Util.h"
 #include "UnitHeap.h"
+#include "csrfile.h"
+#include "parallel.h"
 
 namespace Gorder
 {
 
 using namespace std;
 
+// offsets into outedge/inedge, build with LARGE_GRAPH for more than 2^31 edges
+#ifdef LARGE_GRAPH
+typedef long long EdgeId;
+#else
+typedef int EdgeId;
+#endif
+
 class Vertex{
 public:
-	int outstart;
+	EdgeId outstart;
 	int outdegree;
-	int instart;
+	EdgeId instart;
 	int indegree;
 
 	Vertex(){
@@ -69,6 +79,10 @@ class Graph{
 		~Graph();
 		void clear();
 		void readGraph(const string& fullname);
+		void readBinaryGraph(const string& fullname);
+		template <typename V, typename E>
+		void readCSR(V n, const E* vi, const V* ei);
+		void BuildInEdges();
 		void writeGraph(ostream&);
 		void PrintReOrderedGraph(const vector<int>& order);
 		void GraphAnalysis();
@@ -81,12 +95,55 @@ class Graph{
 		void GapCount();
 		double GapCost(vector<int>& order);
 		void Transform();
+		void Transform(vector<int>& order);
 		void GorderGreedy(vector<int>& order, int window);
+		void InducedSubgraph(int first, int last, Graph& sub);
+		void GorderGreedyParallel(vector<int>& order, int window, int numParts);
 
 		void RCMOrder(vector<int>& order);
 		unsigned long long LocalityScore(const int w);
+		unsigned long long LocalityScore(const vector<int>& order, const int w);
 };
 
+// builds the graph from an in-memory csr (vi has n+1 entries), self loops
+// are dropped and every neighbor list is sorted as readGraph sorts the edges
+template <typename V, typename E>
+void Graph::readCSR(V n, const E* vi, const V* ei){
+	if((unsigned long long)vi[n]>(unsigned long long)numeric_limits<EdgeId>::max()){
+		cout << "too many edges for 32-bit offsets, rebuild with LARGE=1" << endl;
+		quit();
+	}
+	vsize=n;
+	graph.resize(vsize+1);
+	outedge.reserve(vi[n]);
+	for(int u=0; u<vsize; u++){
+		graph[u].outstart=outedge.size();
+		for(E j=vi[u]; j<vi[u+1]; j++){
+			int v=ei[j];
+			if(v==u)
+				continue;
+			outedge.push_back(v);
+			graph[v].indegree++;
+		}
+		sort(outedge.begin()+graph[u].outstart, outedge.end());
+		graph[u].outdegree=outedge.size()-graph[u].outstart;
+	}
+	edgenum=outedge.size();
+
+	graph[0].instart=0;
+	for(int i=1; i<vsize; i++){
+		graph[i].instart=graph[i-1].instart+graph[i-1].indegree;
+	}
+#ifndef Release
+	BuildInEdges();
+#endif
+
+	cout << "vsize: " << vsize << endl;
+	cout << "edgenum: " << edgenum << endl;
+	graph[vsize].outstart=edgenum;
+	graph[vsize].instart=edgenum;
+}
+
 }
 
 #endif
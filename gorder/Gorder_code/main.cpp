@@ -22,10 +22,25 @@ using namespace Gorder;
 
 const int INPUTNUM=1;
 
+// number of distinct ids in [0, n) of order, n when it is a permutation
+static int distinctIds(const vector<int>& order, int n){
+	vector<char> seen(n, 0);
+	int distinct=0;
+	for(int i=0; i<order.size(); i++){
+		if(order[i]>=0 && order[i]<n && seen[order[i]]==0){
+			seen[order[i]]=1;
+			distinct++;
+		}
+	}
+	return distinct;
+}
+
 int main(int argc, char* argv[]){
 	ios::sync_with_stdio(false);
 	int i;
 	int W=5;
+	int threads=1;
+	bool compare=false;
 	clock_t start, end;
 	string filename;
 
@@ -45,6 +60,19 @@ int main(int argc, char* argv[]){
 			}
 			i++;
 		}
+		else if(strcmp("-t", argv[i])==0){
+			i++;
+			threads=atoi(argv[i]);
+			if(threads<=0){
+				cout << "t should be larger than 0" << endl;
+				quit();
+			}
+			i++;
+		}
+		else if(strcmp("-c", argv[i])==0){
+			compare=true;
+			i++;
+		}
 		else{
 			filename=argv[i++];
 		}
@@ -58,17 +86,45 @@ int main(int argc, char* argv[]){
 	g.setFilename(name);
 
 	start=clock();
-	g.readGraph(filename);
+	if(is_bcsr(filename.c_str()))
+		g.readBinaryGraph(filename);
+	else
+		g.readGraph(filename);
 	g.Transform();
 	cout << name << " readGraph is complete." << endl;
 	end=clock();
 	cout << "Time Cost: " << (double)(end-start)/CLOCKS_PER_SEC << endl;
 
-	start=clock();
+	chrono::steady_clock::time_point begin=chrono::steady_clock::now();
 	vector<int> order;
-	g.GorderGreedy(order, W);
-	end=clock();
-	cout << "ReOrdered Time Cost: " << (double)(end-start)/CLOCKS_PER_SEC << endl;
+	if(threads>1){
+		numThreads=threads;
+		g.GorderGreedyParallel(order, W, threads);
+	}else{
+		g.GorderGreedy(order, W);
+	}
+	cout << "ReOrdered Time Cost: " << chrono::duration<double>(chrono::steady_clock::now()-begin).count() << endl;
+
+	if(threads>1){
+		double gap=g.GapCost(order);
+		unsigned long long score=g.LocalityScore(order, W);
+		cout << "parallel: gap cost " << gap << ", locality score " << score << endl;
+		if(compare){
+			vector<int> seqorder;
+			g.GorderGreedy(seqorder, W);
+			double seqgap=g.GapCost(seqorder);
+			unsigned long long seqscore=g.LocalityScore(seqorder, W);
+			cout << "sequential: gap cost " << seqgap << ", locality score " << seqscore << endl;
+			cout << "delta: gap cost " << (seqgap>0 ? 100*(gap-seqgap)/seqgap : 0) << "%, locality score "
+				<< (seqscore>0 ? 100*((double)score-(double)seqscore)/seqscore : 0) << "%" << endl;
+		}
+	}
+	int distinct=distinctIds(order, g.vsize);
+	if(order.size()!=g.vsize || distinct!=g.vsize){
+		cout << "the order is not a permutation: " << distinct << " distinct ids for " << g.vsize << " vertices" << endl;
+		quit();
+	}
+
 	cout << "Begin Output the Reordered Graph" << endl;
 	g.PrintReOrderedGraph(order);
 	cout << endl;
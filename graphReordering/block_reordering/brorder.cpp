@@ -0,0 +1,345 @@
+#include "countingsort.h"
+#include "cachefunc.h"
+#include "brorder.h"
+#include "parallel.h"
+#include <algorithm>
+
+using namespace std;
+
+// brOrder with the block of vertex 0 kept first only when pinZero is set
+template <typename V, typename E>
+static void brOrderBlocks (graphT<V, E>* G1, unsigned int clSize, unsigned int cacheSize, V* newNodeId, bool pinZero)
+{
+    graphT<V, E> G2;
+    vector<V> block;
+
+    graphT<V, E> compG;
+    compG.numVertex = (G1->numVertex-1)/clSize + 1;
+    compG.numEdges = G1->numEdges;
+    compG.VI = new E [compG.numVertex]();
+    compG.EI = new V [compG.numEdges]();
+    compG.numEdges = 0;
+
+    for (V i=0; i<compG.numVertex; i++)
+    {
+        E start = G1->VI[i*clSize];
+        E end = (i==(compG.numVertex-1)) ? G1->numEdges : G1->VI[(i+1)*clSize];
+        // distinct neighbors of the block, highest first
+        block.assign(G1->EI + start, G1->EI + end);
+        sortValues(block.data(), block.size());
+
+        if (i < compG.numVertex-1)
+            compG.VI[i+1] = compG.VI[i];
+        if (start < end)
+        {
+            compG.EI[compG.numEdges++] = block[0];
+            if (i < compG.numVertex-1)
+                compG.VI[i+1]++;
+        }
+        for (E j=1; j<end-start; j++)
+        {
+            if (block[j] != block[j-1])
+            {
+                compG.EI[compG.numEdges++] = block[j];
+                if (i < compG.numVertex-1)
+                    compG.VI[i+1]++;
+            }
+        }
+    }
+
+
+//    freeMem(G1);
+ #ifdef DEBUG
+    printf("new number of vertices are %d\n", compG.numVertex);
+    printf("new number of edges are %llu\n", (unsigned long long) compG.numEdges);
+ #endif
+
+
+
+
+    V* deg = new V [compG.numVertex];
+    for (V i=0; i<compG.numVertex-1; i++)
+        deg[i] = compG.VI[i+1] - compG.VI[i];
+    deg[compG.numVertex-1] = compG.numEdges - compG.VI[compG.numVertex-1];
+
+
+    // another csr that stores edges in reverse direction
+    // to access children of a node
+    createReverseCSR(&compG, &G2, G1->numVertex);
+    V* revDeg = new V [G2.numVertex];
+    for (V i=0; i<G2.numVertex-1; i++)
+        revDeg[i] = G2.VI[i+1] - G2.VI[i];
+    revDeg[G2.numVertex-1] = G2.numEdges - G2.VI[G2.numVertex-1];
+
+
+    //initialize the cost array by in degree of each vertex
+    V* cost = new V [compG.numVertex]();
+    V maxCost = 0;
+    for (V i=0; i<compG.numVertex; i++)
+    {
+        E endId = (i==compG.numVertex-1) ? compG.numEdges : compG.VI[i+1];
+        cost[i] = endId - compG.VI[i];
+        if (cost[i] > maxCost)
+            maxCost = cost[i];
+    }
+
+    V* updates = new V [G1->numVertex]();
+
+
+    // nodeIds keep track of what was the original position of a node in the vertex array
+    V* nodeId = new V [compG.numVertex];
+    for (V i=0; i<compG.numVertex; i++)
+        nodeId[i] = i;
+
+ #ifdef DEBUG
+    printf("sorting begin\n");
+ #endif
+
+    parallelSortPairs(cost, nodeId, compG.numVertex);
+
+    for (V i=0; i<compG.numVertex; i++)
+        cost[i] = maxCost;
+
+
+
+
+ #ifdef DEBUG
+    printf("sorting done\n");
+ #endif
+
+
+
+
+    // CI -> array to keep pounsigned inters of start and end positions of a particular value in cost array
+    // eg. cost array = [0, 0, 1, 1, 3, 4, 4, 7]
+    // then CI = [0, 2, 4, 4, 5, 7, 7, 7]
+    // this array will be used in updating cost array in const time so that it always remains sorted
+    V* CI = new V [maxCost+1];
+    V val = 0;
+    CI[0] = 0;
+    V myId = 0;
+    while(val < maxCost)
+    {
+        while(cost[myId] == val)
+            myId++;
+        while(cost[myId] != val)
+            CI[++val] = myId;
+        myId++;
+    }
+
+ #ifdef DEBUG
+    printf("cache model created\n");
+ #endif
+
+    // nodeMap gives the new position of a vertex in the node array
+    V* nodeMap = new V [compG.numVertex];
+    for (V i=0; i<compG.numVertex; i++)
+        nodeMap[nodeId[i]] = i;
+
+ #ifdef DEBUG
+    printf("node mapping computed\n");
+ #endif
+
+    //keeps track of number of nodes in cache
+    //if greater than cache size, need to evict
+    V currWinCost = 0;
+    //keeps track of oldest node whose parents
+    //are still in cache
+    V currWinStartId = 0;
+    V* cachePresence = new V [G2.numVertex]();
+
+    //array to tell if a node is already processed
+    //cost of these nodes shouldn't be updated and they
+    //shouldn't be bought back unsigned into processing
+    bool* isPlaced = new bool [compG.numVertex]();
+    //array to store the reordered nodeIds
+    // place the lowest cost node first
+    V minPtr = 0;
+
+
+
+    while(minPtr < compG.numVertex)
+    {
+        V origId = nodeId[minPtr];
+        V nodeCost = deg[origId] - (maxCost - cost[minPtr]);
+        while(updates[origId] > 0)
+        {
+            updates[origId]--;
+            moveRight(origId, cost, nodeMap, nodeId, CI);
+            origId = nodeId[minPtr];
+        }
+        if (deg[origId] > cacheSize)
+        {
+        //special case, handle separately
+            isPlaced[origId] = true;
+            minPtr++;
+            continue;
+        }
+        while((currWinCost + nodeCost > cacheSize) && (currWinStartId < minPtr-3))
+        {
+            //evict
+            if (deg[nodeId[currWinStartId]] <= cacheSize)
+                currWinCost -= evictParents(currWinStartId, &compG, &G2, CI, cost, cachePresence, isPlaced, nodeId, nodeMap, revDeg, updates);
+            origId = nodeId[minPtr];
+            while(updates[origId] > 0)
+            {
+                updates[origId]--;
+                moveRight(origId, cost, nodeMap, nodeId, CI);
+                origId = nodeId[minPtr];
+            }
+            nodeCost = deg[origId] - (maxCost - cost[minPtr]);
+            currWinStartId++;
+            if (deg[origId] > cacheSize)
+            {
+            //special case, handle separately
+                break;
+            }
+        }
+        if (deg[origId] > cacheSize)
+        {
+            isPlaced[origId] = true;
+            minPtr++;
+            continue;
+        }
+        while(updates[origId] > 0)
+        {
+            updates[origId]--;
+            moveRight(origId, cost, nodeMap, nodeId, CI);
+            origId = nodeId[minPtr];
+        }
+        if (nodeCost < 0)
+            printf("deg = %d, node = %d, nodecost = %d, cost=%d, updates left = %d\n",deg[origId], minPtr, nodeCost, cost[minPtr], updates[origId]);
+
+        //special case, handle separately
+        isPlaced[origId] = true;
+        //put parents in cache
+        currWinCost += loadParents(minPtr, &compG, &G2, CI, cost, cachePresence, isPlaced, nodeId, nodeMap, revDeg, updates, minPtr);
+        minPtr++;
+    }
+    //there is no reordering if only 2 vertices are left
+    //who are already sorted on cost
+    if (compG.numVertex > 1) isPlaced[nodeId[compG.numVertex-2]] = true;;
+    isPlaced[nodeId[compG.numVertex-1]] = true;
+
+    for (V i=0; i<compG.numVertex; i++)
+    {
+        if (!isPlaced[i])
+        {
+            printf("ERROR -> failed to place %d\n", i);
+            break;
+        }
+    }
+
+ #ifdef DEBUG
+    printf("reordering computed\n");
+ #endif
+  if (pinZero && nodeMap[0] != 0) {
+    V zeros_map = nodeMap[0];
+    nodeMap[0] = 0;
+    nodeId[0] = 0;
+    for(V i = 1; i < compG.numVertex; ++i){
+      if (nodeMap[i] == 0) {
+        nodeMap[i] = zeros_map;
+        nodeId[zeros_map] = i;
+        break;
+      }
+    }
+  }
+
+    // expand the blocks into their vertices
+    V nodeExpCount = 0;
+    for (V i=0; i<compG.numVertex; i++)
+    {
+        V clId = nodeId[i];
+        V baseNode = clId*clSize;
+        V numNodes = (clId == (compG.numVertex-1)) ? G1->numVertex - baseNode : clSize;
+        for (V j=0; j<numNodes; j++)
+            newNodeId[nodeExpCount++] = baseNode + j;
+    }
+
+    freeMem(&G2);
+    freeMem(&compG);
+    delete[] deg;
+    delete[] revDeg;
+    delete[] cost;
+    delete[] nodeId;
+    delete[] nodeMap;
+    delete[] CI;
+    delete[] updates;
+    delete[] cachePresence;
+    delete[] isPlaced;
+}
+
+template <typename V, typename E>
+void brOrder (graphT<V, E>* G1, unsigned int clSize, unsigned int cacheSize, V* newNodeId)
+{
+    brOrderBlocks(G1, clSize, cacheSize, newNodeId, maintain);
+}
+
+unsigned int brBlockSize (unsigned int lineSize, unsigned int propSize)
+{
+    unsigned int verts = (propSize == 0) ? lineSize : lineSize / propSize;
+    return (verts == 0) ? 1 : verts;
+}
+
+unsigned int brWindowSize (unsigned long long capacity, unsigned int propSize)
+{
+    unsigned long long entries = (propSize == 0) ? capacity : capacity / propSize;
+    if (entries > 0xffffffffULL)
+        entries = 0xffffffffULL;
+    return (entries == 0) ? 1 : (unsigned int) entries;
+}
+
+template <typename V, typename E>
+void brOrderHierarchical (graphT<V, E>* G1, unsigned int lineVerts, unsigned int l1Window, unsigned int llcWindow, V* newNodeId)
+{
+    V n = G1->numVertex;
+    V* inner = new V [n];
+    // maintain is applied once to the composed order below
+    brOrderBlocks(G1, lineVerts, l1Window, inner, false);
+
+    V* innerMap = new V [n];
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long i=start; i<end; i++)
+            innerMap[inner[i]] = i;
+    });
+    graphT<V, E> R;
+    permute_csr(G1, inner, innerMap, &R);
+
+    // rows whose neighbors fill one l1 window on average, whole lines only
+    unsigned long long group = (G1->numEdges > 0) ? (unsigned long long) l1Window * n / G1->numEdges : n;
+    group -= group % lineVerts;
+    if (group < lineVerts)
+        group = lineVerts;
+    if (group > n)
+        group = (n == 0) ? 1 : n;
+ #ifdef DEBUG
+    printf("llc pass over groups of %llu vertices\n", group);
+ #endif
+
+    V* outer = new V [n];
+    brOrderBlocks(&R, (unsigned int) group, llcWindow, outer, false);
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long i=start; i<end; i++)
+            newNodeId[i] = inner[outer[i]];
+    });
+
+    // the line block of vertex 0 goes first, the rest keeps its order
+    if (maintain && n > 0 && newNodeId[0] != 0)
+    {
+        V len = (lineVerts < n) ? lineVerts : n;
+        stable_partition(newNodeId, newNodeId + n, [&](V v) { return v < len; });
+    }
+
+    freeMem(&R);
+    delete[] inner;
+    delete[] innerMap;
+    delete[] outer;
+}
+
+#define INSTANTIATE_BRORDER(V, E) \
+    template void brOrder (graphT<V, E>*, unsigned int, unsigned int, V*); \
+    template void brOrderHierarchical (graphT<V, E>*, unsigned int, unsigned int, unsigned int, V*);
+
+INSTANTIATE_BRORDER(unsigned int, unsigned int)
+INSTANTIATE_BRORDER(unsigned int, unsigned long long)
@@ -0,0 +1,25 @@
+#ifndef BRORDER_HEADER_INCL
+#define BRORDER_HEADER_INCL
+
+#include "graph.h"
+
+// block reordering of the csr G1 (left unchanged). groups of clSize consecutive
+// vertices are ordered as one node with the pH cache model of cacheSize entries,
+// newNodeId[i] is set to the vertex placed at position i.
+// with maintain the block of vertex 0 stays first, brOrderHierarchical applies it once
+// to the composed order
+template <typename V, typename E>
+void brOrder (graphT<V, E>*, unsigned int, unsigned int, V*);
+
+// block size (vertices per line) and window budget (vertex properties a cache of
+// the given capacity holds) for vertex properties of propSize bytes
+unsigned int brBlockSize (unsigned int lineSize, unsigned int propSize);
+unsigned int brWindowSize (unsigned long long capacity, unsigned int propSize);
+
+// two level BR: line sized blocks are ordered with the l1 window first, then runs of
+// that order holding about one l1 window worth of rows are ordered as blocks with the
+// llc window, so the l1 order is kept inside every run
+template <typename V, typename E>
+void brOrderHierarchical (graphT<V, E>*, unsigned int, unsigned int, unsigned int, V*);
+
+#endif
@@ -1,10 +1,11 @@
 #include "cachefunc.h"
 
-void moveRight(unsigned int id, unsigned int* cost, unsigned int* nodeMap, unsigned int* nodeId, unsigned int* CI)
+template <typename V>
+void moveRight(V id, V* cost, V* nodeMap, V* nodeId, V* CI)
 {
-    unsigned int nodeCost = cost[nodeMap[id]];
-    unsigned int temp = nodeMap[id];
-    unsigned int replacedNode = nodeId[CI[nodeCost+1]-1];
+    V nodeCost = cost[nodeMap[id]];
+    V temp = nodeMap[id];
+    V replacedNode = nodeId[CI[nodeCost+1]-1];
     nodeMap[id] = CI[nodeCost+1]-1;
     nodeMap[replacedNode] = temp;
     nodeId[CI[nodeCost+1]-1] = id;
@@ -13,13 +14,14 @@ void moveRight(unsigned int id, unsigned int* cost, unsigned int* nodeMap, unsig
     CI[nodeCost+1]--;
 }
 
-void moveLeft(unsigned int id, unsigned int* cost, unsigned int* nodeMap, unsigned int* nodeId, unsigned int* CI, unsigned int minPtr)
+template <typename V>
+void moveLeft(V id, V* cost, V* nodeMap, V* nodeId, V* CI, V minPtr)
 {
-    unsigned int nodeCost = cost[nodeMap[id]];
-    unsigned int temp = nodeMap[id];
+    V nodeCost = cost[nodeMap[id]];
+    V temp = nodeMap[id];
     if (CI[nodeCost] <= minPtr)
         CI[nodeCost] = minPtr+1;
-    unsigned int replacedNode = nodeId[CI[nodeCost]];
+    V replacedNode = nodeId[CI[nodeCost]];
     nodeMap[id] = CI[nodeCost];
     nodeId[CI[nodeCost]] = id;
     nodeMap[replacedNode] = temp;
@@ -30,28 +32,29 @@ void moveLeft(unsigned int id, unsigned int* cost, unsigned int* nodeMap, unsign
     CI[nodeCost]++;
 }
 
-unsigned int evictParents (unsigned int node, graph* G1, graph* G2, unsigned int* CI, unsigned int* cost, unsigned int* cachePresence, bool* isPlaced, unsigned int* nodeId, unsigned int* nodeMap, unsigned int* revDeg, unsigned int* updates)
+template <typename V, typename E>
+V evictParents (V node, graphT<V, E>* G1, graphT<V, E>* G2, V* CI, V* cost, V* cachePresence, bool* isPlaced, V* nodeId, V* nodeMap, V* revDeg, V* updates)
 {
-    unsigned int numParentsEvicted = 0;
-    unsigned int origId = nodeId[node];
-    unsigned int parentStartId = G1->VI[origId];
-    unsigned int parentEndId = (origId==(G1->numVertex-1)) ? G1->numEdges : G1->VI[origId+1];
+    V numParentsEvicted = 0;
+    V origId = nodeId[node];
+    E parentStartId = G1->VI[origId];
+    E parentEndId = (origId==(G1->numVertex-1)) ? G1->numEdges : G1->VI[origId+1];
     //for every parent
-    for (unsigned int i=parentStartId; i<parentEndId; i++)
+    for (E i=parentStartId; i<parentEndId; i++)
     {
         //find out if the parent should be evicted
         //if yes, evict and increase the cost of its children 
-        unsigned int parentId = G1->EI[i];
+        V parentId = G1->EI[i];
         cachePresence[parentId]--;
         if (cachePresence[parentId] == 0)
         {
             //increase the cost of their children
-            unsigned int childIdStart = G2->VI[parentId];
-            unsigned int childIdEnd = (parentId==G2->numVertex-1) ? G2->numEdges : G2->VI[parentId+1];
-            for (unsigned int j=childIdStart; j<childIdEnd; j++)
+            E childIdStart = G2->VI[parentId];
+            E childIdEnd = (parentId==G2->numVertex-1) ? G2->numEdges : G2->VI[parentId+1];
+            for (E j=childIdStart; j<childIdEnd; j++)
             {
                 //update the new location after cost reduction
-                unsigned int childId = G2->EI[j];
+                V childId = G2->EI[j];
                 if (!isPlaced[childId])
                     updates[childId]++;
                 //if the child is not already placed in the order
@@ -64,26 +67,27 @@ unsigned int evictParents (unsigned int node, graph* G1, graph* G2, unsigned int
 } 
 
 
-unsigned int loadParents (unsigned int nodePtr, graph* G1, graph* G2, unsigned int* CI, unsigned int* cost, unsigned int* cachePresence, bool* isPlaced, unsigned int* nodeId, unsigned int* nodeMap, unsigned int* revDeg, unsigned int*updates, unsigned int minPtr)
+template <typename V, typename E>
+V loadParents (V nodePtr, graphT<V, E>* G1, graphT<V, E>* G2, V* CI, V* cost, V* cachePresence, bool* isPlaced, V* nodeId, V* nodeMap, V* revDeg, V*updates, V minPtr)
 {
-    unsigned int numParentsLoaded = 0;
-    unsigned int origId = nodeId[nodePtr];
-    unsigned int parentIdStart = G1->VI[origId];
-    unsigned int parentIdEnd = (origId==(G1->numVertex-1)) ? G1->numEdges : G1->VI[origId+1];
-    for (unsigned int i=parentIdStart; i<parentIdEnd; i++)
+    V numParentsLoaded = 0;
+    V origId = nodeId[nodePtr];
+    E parentIdStart = G1->VI[origId];
+    E parentIdEnd = (origId==(G1->numVertex-1)) ? G1->numEdges : G1->VI[origId+1];
+    for (E i=parentIdStart; i<parentIdEnd; i++)
     {
-        unsigned int parentId = G1->EI[i];
+        V parentId = G1->EI[i];
         cachePresence[parentId]++;
 
         //reduce the cost of their children
-        unsigned int childIdStart = G2->VI[parentId];
-        unsigned int childIdEnd = (parentId==G2->numVertex-1) ? G2->numEdges : G2->VI[parentId+1];
+        E childIdStart = G2->VI[parentId];
+        E childIdEnd = (parentId==G2->numVertex-1) ? G2->numEdges : G2->VI[parentId+1];
         if (cachePresence[parentId]==1) //this implies that element wasn't in cache before
         {
-            for (unsigned int j=childIdStart; j<childIdEnd; j++)
+            for (E j=childIdStart; j<childIdEnd; j++)
             {
                 //update the new location after cost reduction
-                unsigned int childId = G2->EI[j];
+                V childId = G2->EI[j];
                 //if the child's processing order isn't yet fixed
                 //update it, otherwise leave it
                 if (!isPlaced[childId])
@@ -99,3 +103,13 @@ unsigned int loadParents (unsigned int nodePtr, graph* G1, graph* G2, unsigned i
     }
     return numParentsLoaded;
 }
+
+template void moveRight (unsigned int, unsigned int*, unsigned int*, unsigned int*, unsigned int*);
+template void moveLeft (unsigned int, unsigned int*, unsigned int*, unsigned int*, unsigned int*, unsigned int);
+
+#define INSTANTIATE_CACHEFUNC(V, E) \
+    template V evictParents (V, graphT<V, E>*, graphT<V, E>*, V*, V*, V*, bool*, V*, V*, V*, V*); \
+    template V loadParents (V, graphT<V, E>*, graphT<V, E>*, V*, V*, V*, bool*, V*, V*, V*, V*, V);
+
+INSTANTIATE_CACHEFUNC(unsigned int, unsigned int)
+INSTANTIATE_CACHEFUNC(unsigned int, unsigned long long)
@@ -3,9 +3,13 @@
 #include <stdlib.h>
 #include <math.h>
 #include <sys/time.h>
-#include "sort.h"
-#include "cachefunc.h"
+#include "brorder.h"
+#include "parallel.h"
 #include <cstring>
+#include <cctype>
+#include <vector>
+#include <algorithm>
+#include <functional>
 #ifndef GRAPH_HEADER_INCL
 #include "graph.h"
 #endif
@@ -20,383 +24,180 @@ using namespace std;
 unsigned int CLSize = 20;
 unsigned int CACHE_SIZE = 100000;
 
+// cache geometry, when given the block size and window are derived from it
+// propSize: bytes per vertex property, lineSize: bytes per line,
+// cacheLevels: capacity of every level in bytes, L1 first
+unsigned int propSize = 4;
+unsigned int lineSize = 64;
+vector<unsigned long long> cacheLevels;
+bool geometry = false;
+// order for the L1 and the last level window together
+bool hierarchical = false;
+
+template <typename V, typename E>
+int reorder (char*, char*);
+
+// "32K,1M,32M" -> capacities in bytes
+static bool parseLevels (const char* list, vector<unsigned long long>& levels)
+{
+    const char* p = list;
+    while (*p != '\0')
+    {
+        char* end;
+        unsigned long long size = strtoull(p, &end, 10);
+        if (end == p)
+            return false;
+        if (*end == 'K' || *end == 'k') { size <<= 10; end++; }
+        else if (*end == 'M' || *end == 'm') { size <<= 20; end++; }
+        else if (*end == 'G' || *end == 'g') { size <<= 30; end++; }
+        levels.push_back(size);
+        if (*end == ',')
+            end++;
+        else if (*end != '\0')
+            return false;
+        p = end;
+    }
+    return !levels.empty();
+}
 
-void merge(unsigned int*, unsigned int*, unsigned int, unsigned int, unsigned int);
-
-void mergeSort (unsigned int*, unsigned int*, unsigned int, unsigned int);
 bool weighted = false, maintain = false, indegree = false;
 int main(int argc, char** argv)
 {
 	cout << "============================" << endl;
-    if (argc > 4)
+    if (argc < 3)
     {
-        CLSize = atoi(argv[1]);
-        CACHE_SIZE = atoi(argv[2]);
+        printf("Usage : %s <cacheLineSize>(optional) <cacheCapacity>(optional) <--prop bytes(optional)> <--line bytes(optional)> <--caches L1,L2,..,LLC bytes(optional)> <--hierarchical(optional)> <--maintain(optional)> <--weighted(optional)> <--indegree(optional)> <--threads n(optional)> <--verify(optional)> <inputFile1> <outputFile> \n", argv[0]);
+        exit(1);
     }
-    else if (argc != 3)
+    // the two numbers are vertices per block and window entries
+    int first = 1;
+    if (argc > 4 && isdigit(argv[1][0]) && isdigit(argv[2][0]))
     {
-        printf("Usage : %s <cacheLineSize>(optional) <cacheCapacity>(optional) <inputFile1> <outputFile> \n", argv[0]);
-        exit(1);
+        CLSize = atoi(argv[1]);
+        CACHE_SIZE = atoi(argv[2]);
+        first = 3;
     }
-    for (int i = 3; i < argc-2; i++){
+    for (int i = first; i < argc-2; i++){
       char * opt = argv[i];
       if (strcmp(opt, "-m") == 0 || strcmp(opt,"--maintain") == 0) maintain = true;
       else if (strcmp(opt, "-i") == 0 || strcmp(opt,"--indegree") == 0) indegree = true;
       else if (strcmp(opt, "-w") == 0 || strcmp(opt,"--weighted") == 0) weighted = true;
+      else if ((strcmp(opt, "-t") == 0 || strcmp(opt,"--threads") == 0) && i+1 < argc-2) numThreads = atoi(argv[++i]);
+      else if (strcmp(opt, "--verify") == 0) verifyChecksum = true;
+      else if (strcmp(opt, "--prop") == 0 && i+1 < argc-2) { propSize = atoi(argv[++i]); geometry = true; }
+      else if (strcmp(opt, "--line") == 0 && i+1 < argc-2) { lineSize = atoi(argv[++i]); geometry = true; }
+      else if (strcmp(opt, "--caches") == 0 && i+1 < argc-2)
+      {
+          if (!parseLevels(argv[++i], cacheLevels))
+          {
+              fprintf(stderr, "bad cache capacities %s, expected e.g. 32K,1M,32M\n", argv[i]);
+              exit(1);
+          }
+          geometry = true;
+      }
+      else if (strcmp(opt, "--hierarchical") == 0) hierarchical = true;
       // cout << *opt;
       cout << maintain << " " << indegree << " " << weighted << endl;
     }
 
-    // graph objects
-    graph G1, G2;
-
-    // read csr file
-    if (read_csr(argv[argc-2], &G1)==-1)
-        exit(1);
-
- #ifdef DEBUG
-    printf("file reading done. Num vertices = %d and numEdges = %d\n", G1.numVertex, G1.numEdges);
- #endif
-
-
-    unsigned int degThresh = (G1.numVertex) + 1;
-//    printGraph(&G1);
-
-    graph compG;
-    compG.numVertex = (G1.numVertex-1)/CLSize + 1;
-    compG.numEdges = G1.numEdges;
-    compG.VI = new unsigned int [compG.numVertex]();
-    compG.EI = new unsigned int [compG.numEdges]();
-    compG.numEdges = 0;
-
-    for (unsigned int i=0; i<compG.numVertex; i++)
+    if (geometry)
     {
-        unsigned int start = G1.VI[i*CLSize];
-        unsigned int end = (i==(compG.numVertex-1)) ? G1.numEdges : G1.VI[(i+1)*CLSize];
-        mergeSortWOkey(G1.EI, start, end-1);
-
-        if (i < compG.numVertex-1)
-            compG.VI[i+1] = compG.VI[i];
-        if (start < end)
-        {
-            compG.EI[compG.numEdges++] = G1.EI[start];
-            if (i < compG.numVertex-1)
-                compG.VI[i+1]++;
-        }
-        for (unsigned int j=start+1; j<end; j++)
-        {
-            if ((G1.EI[j]) != (G1.EI[j-1]))
-            {
-                compG.EI[compG.numEdges++] = G1.EI[j];
-                if (i < compG.numVertex-1)
-                    compG.VI[i+1]++;
-            }
-        }
+        CLSize = brBlockSize(lineSize, propSize);
+        if (!cacheLevels.empty())
+            CACHE_SIZE = brWindowSize(cacheLevels.back(), propSize);
     }
-
-
-//    freeMem(&G1);
- #ifdef DEBUG
-    printf("new number of vertices are %d\n", compG.numVertex);
-    printf("new number of edges are %d\n", compG.numEdges);
- #endif
-
-
-
-
-    unsigned int* deg = new unsigned int [compG.numVertex];
-    for (unsigned int i=0; i<compG.numVertex-1; i++)
-        deg[i] = compG.VI[i+1] - compG.VI[i];
-    deg[compG.numVertex-1] = compG.numEdges - compG.VI[compG.numVertex-1];
-
-
-    // another csr that stores edges in reverse direction
-    // to access children of a node
-    createReverseCSR(&compG, &G2, G1.numVertex);
-    unsigned int* revDeg = new unsigned int [G2.numVertex];
-    for (unsigned int i=0; i<G2.numVertex-1; i++)
-        revDeg[i] = G2.VI[i+1] - G2.VI[i];
-    revDeg[G2.numVertex-1] = G2.numEdges - G2.VI[G2.numVertex-1];
-
-
-    //initialize the cost array by in degree of each vertex
-    unsigned int* cost = new unsigned int [compG.numVertex]();
-    unsigned int maxCost = 0;
-    for (unsigned int i=0; i<compG.numVertex; i++)
+    if (hierarchical && cacheLevels.size() < 2)
     {
-        unsigned int endId = (i==compG.numVertex-1) ? compG.numEdges : compG.VI[i+1];
-        cost[i] = endId - compG.VI[i];
-        if (cost[i] > maxCost)
-            maxCost = cost[i];
+        fputs("--hierarchical needs the L1 and the last level capacity in --caches\n", stderr);
+        exit(1);
     }
+    if (hierarchical)
+        printf("block = %u vertices, L1 window = %u, LLC window = %u\n", CLSize, brWindowSize(cacheLevels.front(), propSize), CACHE_SIZE);
+    else
+        printf("block = %u vertices, window = %u\n", CLSize, CACHE_SIZE);
+
+    // 64-bit edge offsets only when the graph needs them
+    if (needs_wide_offsets(argv[argc-2]))
+        return reorder<unsigned int, unsigned long long>(argv[argc-2], argv[argc-1]);
+    return reorder<unsigned int, unsigned int>(argv[argc-2], argv[argc-1]);
+}
 
-    unsigned int* updates = new unsigned int [G1.numVertex]();
-
-
-    // nodeIds keep track of what was the original position of a node in the vertex array
-    unsigned int* nodeId = new unsigned int [compG.numVertex];
-    for (unsigned int i=0; i<compG.numVertex; i++)
-        nodeId[i] = i;
-
- #ifdef DEBUG
-    printf("sorting begin\n");
- #endif
-
-    mergeSort(cost, nodeId, 0, compG.numVertex-1);
-
-    for (unsigned int i=0; i<compG.numVertex; i++)
-        cost[i] = maxCost;
-
-
+template <typename V, typename E>
+int reorder (char* inFile, char* outFile)
+{
+    // graph objects
+    graphT<V, E> G1, G2;
 
+    // read csr file, the .sg / .wsg output also needs the reverse csr
+    bool serialized = is_serialized_graph(outFile);
+    if (read_csr(inFile, &G1, serialized ? &G2 : NULL)==-1)
+        exit(1);
 
  #ifdef DEBUG
-    printf("sorting done\n");
+    printf("file reading done. Num vertices = %d and numEdges = %llu\n", G1.numVertex, (unsigned long long) G1.numEdges);
  #endif
 
-
-
+    V* newNodeId = new V [G1.numVertex];
+    V* newNodeMap = new V [G1.numVertex];
 
     clock_t start, end;
     start = clock();
-    // CI -> array to keep pounsigned inters of start and end positions of a particular value in cost array
-    // eg. cost array = [0, 0, 1, 1, 3, 4, 4, 7]
-    // then CI = [0, 2, 4, 4, 5, 7, 7, 7]
-    // this array will be used in updating cost array in const time so that it always remains sorted
-    unsigned int* CI = new unsigned int [maxCost+1];
-    unsigned int val = 0;
-    CI[0] = 0;
-    unsigned int myId = 0;
-    while(val < maxCost)
-    {
-        while(cost[myId] == val)
-            myId++;
-        while(cost[myId] != val)
-            CI[++val] = myId;
-        myId++;
-    }
-
- #ifdef DEBUG
-    printf("cache model created\n");
- #endif
-
-    // nodeMap gives the new position of a vertex in the node array
-    unsigned int* nodeMap = new unsigned int [compG.numVertex];
-    for (unsigned int i=0; i<compG.numVertex; i++)
-        nodeMap[nodeId[i]] = i;
-
- #ifdef DEBUG
-    printf("node mapping computed\n");
- #endif
-
-    //keeps track of number of nodes in cache
-    //if greater than cache size, need to evict
-    unsigned int currWinCost = 0;
-    //keeps track of oldest node whose parents
-    //are still in cache
-    unsigned int currWinStartId = 0;
-    unsigned int* cachePresence = new unsigned int [G2.numVertex]();
-
-    //array to tell if a node is already processed
-    //cost of these nodes shouldn't be updated and they
-    //shouldn't be bought back unsigned into processing
-    bool* isPlaced = new bool [compG.numVertex]();
-    //array to store the reordered nodeIds
-    // place the lowest cost node first
-    unsigned int minPtr = 0;
-
-
-
-    while(minPtr < compG.numVertex)
-    {
-        unsigned int origId = nodeId[minPtr];
-        unsigned int nodeCost = deg[origId] - (maxCost - cost[minPtr]);
-        while(updates[origId] > 0)
-        {
-            updates[origId]--;
-            moveRight(origId, cost, nodeMap, nodeId, CI);
-            origId = nodeId[minPtr];
-        }
-        if (deg[origId] > CACHE_SIZE)
-        {
-        //special case, handle separately
-            isPlaced[origId] = true;
-            minPtr++;
-            continue;
-        }
-        while((currWinCost + nodeCost > CACHE_SIZE) && (currWinStartId < minPtr-3))
-        {
-            //evict
-            if (deg[nodeId[currWinStartId]] <= CACHE_SIZE)
-                currWinCost -= evictParents(currWinStartId, &compG, &G2, CI, cost, cachePresence, isPlaced, nodeId, nodeMap, revDeg, updates);
-            origId = nodeId[minPtr];
-            while(updates[origId] > 0)
-            {
-                updates[origId]--;
-                moveRight(origId, cost, nodeMap, nodeId, CI);
-                origId = nodeId[minPtr];
-            }
-            nodeCost = deg[origId] - (maxCost - cost[minPtr]);
-            currWinStartId++;
-            if (deg[origId] > CACHE_SIZE)
-            {
-            //special case, handle separately
-                break;
-            }
-        }
-        if (deg[origId] > CACHE_SIZE)
-        {
-            isPlaced[origId] = true;
-            minPtr++;
-            continue;
-        }
-        while(updates[origId] > 0)
-        {
-            updates[origId]--;
-            moveRight(origId, cost, nodeMap, nodeId, CI);
-            origId = nodeId[minPtr];
-        }
-        if (nodeCost < 0)
-            printf("deg = %d, node = %d, nodecost = %d, cost=%d, updates left = %d\n",deg[origId], minPtr, nodeCost, cost[minPtr], updates[origId]);
-
-        //special case, handle separately
-        isPlaced[origId] = true;
-        //put parents in cache
-        currWinCost += loadParents(minPtr, &compG, &G2, CI, cost, cachePresence, isPlaced, nodeId, nodeMap, revDeg, updates, minPtr);
-        minPtr++;
-    }
-    cout << "Here1..\n";
-    //there is no reordering if only 2 vertices are left
-    //who are already sorted on cost
-    // cout << compG.numVertex-1 << " " << compG.numVertex-2 << endl;
-    if (compG.numVertex > 1) isPlaced[nodeId[compG.numVertex-2]] = true;;
-    isPlaced[nodeId[compG.numVertex-1]] = true;
-
+    if (hierarchical)
+        brOrderHierarchical(&G1, CLSize, brWindowSize(cacheLevels.front(), propSize), CACHE_SIZE, newNodeId);
+    else
+        brOrder(&G1, CLSize, CACHE_SIZE, newNodeId);
     end = clock();
 
    // printf("Total time taken for reordering %s is %lf seconds\n", argv[argc-1], (double)(end-start)/CLOCKS_PER_SEC);
-    printf("%s, %lf \n", argv[argc-1], (double)(end-start)/CLOCKS_PER_SEC);
-    cout << "Here2..\n";
-    for (unsigned int i=0; i<compG.numVertex; i++)
-    {
-        if (!isPlaced[i])
-        {
-            printf("ERROR -> failed to place %d\n", i);
-            break;
-        }
-    }
-
- #ifdef DEBUG
-    printf("reordering computed\n");
- #endif
-  if (maintain && nodeMap[0] != 0) {
-    unsigned int zeros_map = nodeMap[0];
-    nodeMap[0] = 0;
-    nodeId[0] = 0;
-    for(unsigned int i = 1; i < G2.numVertex; ++i){
-      if (nodeMap[i] == 0) {
-        nodeMap[i] = zeros_map;
-        nodeId[zeros_map] = i;
-        cout << "Mapped " << i << " to " << zeros_map << endl;
-        break;
-      }
-    }
-  }
-
-    //// apply the new order to existing graph
-    //// new reordered graph
-    freeMem(&G2);
-
-    freeMem(&G1);
-    freeMem(&compG);
-    delete[] cost;
-    delete[] nodeMap;
-    delete[] CI;
-    delete[] updates;
-    delete[] cachePresence;
-    delete[] isPlaced;
-
-    if (read_csr(argv[argc-2], &G1)==-1)
-        exit(1);
+    printf("%s, %lf \n", outFile, (double)(end-start)/CLOCKS_PER_SEC);
 
-
-    unsigned int* newNodeId = new unsigned int [G1.numVertex];
-    unsigned int* newNodeMap = new unsigned int [G1.numVertex];
-    isPlaced = new bool [G1.numVertex]();
-
-    unsigned int nodeExpCount = 0;
-    for (unsigned int i=0; i<compG.numVertex; i++)
-    {
-        unsigned int clId = nodeId[i];
-        unsigned int baseNode = clId*CLSize;
-        unsigned int numNodes = (clId == (compG.numVertex-1)) ? G1.numVertex - baseNode : CLSize;
-        for (unsigned int j=0; j<numNodes; j++)
-            newNodeId[nodeExpCount++] = baseNode + j;
-    }
-    for (unsigned int i=0; i<G1.numVertex; i++)
+    for (V i=0; i<G1.numVertex; i++)
     {
         newNodeMap[newNodeId[i]] = i;
     }
 
     if (maintain && newNodeMap[0] != 0) {
-      unsigned int zeros_map = newNodeMap[0];
+      V zeros_map = newNodeMap[0];
       newNodeMap[0] = 0;
-      unsigned int z_id = newNodeId[0];
       newNodeId[0] = 0;
-      for(unsigned int i = 1; i < G2.numVertex; ++i){
+      for(V i = 1; i < G1.numVertex; ++i){
         if (newNodeMap[i] == 0) {
           newNodeMap[i] = zeros_map;
-          newNodeId[z_id] = i;
+          newNodeId[zeros_map] = i;
 //          cout << "Mapped " << i << " to " << zeros_map << endl;
           break;
         }
       }
     }
 
-    G2.numVertex = G1.numVertex;
-    G2.numEdges = G1.numEdges;
-    G2.weights = G1.weights;
-    G2.VI = new unsigned int[G2.numVertex];
-    G2.EI = new unsigned int[G2.numEdges];
-    G2.VI[0] = 0;
-    for (unsigned int i=1; i<G2.numVertex; i++)
+    if (serialized)
     {
-        unsigned int prevNodeId = newNodeId[i-1];
-        unsigned int parentStartId = G1.VI[prevNodeId];
-        unsigned int parentEndId = (prevNodeId == G1.numVertex-1) ? G1.numEdges : G1.VI[prevNodeId+1];
-        G2.VI[i] = G2.VI[i-1] + (parentEndId - parentStartId);
-        unsigned int tempId = 0;
-        for (unsigned int j=G2.VI[i-1]; j<G2.VI[i]; j++)
-        {
-            G2.EI[j] = newNodeMap[G1.EI[parentStartId + tempId]];
-            tempId++;
-        }
+        // permuted and written in one go, no edge list for the converter
+        if (G2.VI == NULL)
+            createReverseCSR(&G1, &G2, G1.numVertex);
+        if (write_serialized_graph(outFile, &G1, &G2, newNodeId, newNodeMap) < 0)
+            exit(1);
     }
-
-    unsigned int prevNodeId = newNodeId[G2.numVertex-1];
-    unsigned int parentStartId = G1.VI[prevNodeId];
-    unsigned int tempId = 0;
-    for (unsigned int i=G2.VI[G2.numVertex-1]; i<G2.numEdges; i++)
+    else
     {
-       G2.EI[i] = newNodeMap[G1.EI[parentStartId + tempId]];
-       tempId++;
-    }
+        permute_csr(&G1, newNodeId, newNodeMap, &G2);
 
  #ifdef DEBUG
-    printf("reordering applied\n");
+        printf("reordering applied\n");
  #endif
 
 
-    // write_csr(argv[argc-1], &G2);
-    write_edge_list(argv[argc-1], &G2, newNodeMap);
+        // write_csr(argv[argc-1], &G2);
+        write_edge_list(outFile, &G2, newNodeMap);
+    }
+    if (write_original_order("new_order.el", &G1, (const V*) newNodeMap) < 0)
+        exit(1);
 //    FILE* fMap = fopen("fMap.bin", "wb");
 //    fwrite(newNodeId, sizeof(unsigned int), G2.numVertex, fMap);
 //    fclose(fMap);
 
     freeMem(&G1);
     freeMem(&G2);
-    delete[] nodeId;
-    delete[] isPlaced;
     delete[] newNodeId;
     delete[] newNodeMap;
 cout <<" ======================" << endl;
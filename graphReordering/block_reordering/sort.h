@@ -1,11 +0,0 @@
-#include <iostream>
-#include <stdio.h>
-#include <stdlib.h>
-
-void merge(unsigned int*, unsigned int*, unsigned int, unsigned int, unsigned int);
-
-void mergeSort (unsigned int*, unsigned int*, unsigned int, unsigned int); 
-
-void mergeWOkey (unsigned int*, unsigned int, unsigned int, unsigned int);
-
-void mergeSortWOkey (unsigned int*, unsigned int, unsigned int);
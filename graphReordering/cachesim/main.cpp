@@ -0,0 +1,467 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "parallel.h"
+#include "locality.h"
+#include "stackdist.h"
+#ifndef GRAPH_HEADER_INCL
+#include "graph.h"
+#endif
+
+using namespace std;
+
+bool weighted = false, maintain = false, indegree = false;
+
+// traversal whose vertex property stream is replayed: pr, bfs, cc or sssp
+const char* app = "pr";
+// bytes per vertex property (0: the type the graphit app uses), bytes per line
+unsigned int propSize = 0;
+unsigned int lineSize = 64;
+// lru capacities in bytes
+vector<unsigned long long> cacheSizes;
+// pagerank iterations, bfs and sssp source (an id of the reordered graph, as in the apps)
+unsigned int iterations = 1;
+unsigned int source = 0;
+// every range but the first replays warmup x the largest cache (in lines, at most
+// the lines of the data) accesses before it is counted
+double warmup = 4;
+bool printHist = false;
+
+const unsigned int HIST_BUCKETS = 40;
+
+template <typename V, typename E>
+int simulate (char*, vector<char*>&);
+
+// "32K,1M,32M" -> capacities in bytes, as in br
+static bool parseSizes (const char* list, vector<unsigned long long>& sizes)
+{
+    const char* p = list;
+    while (*p != '\0')
+    {
+        char* end;
+        unsigned long long size = strtoull(p, &end, 10);
+        if (end == p)
+            return false;
+        if (*end == 'K' || *end == 'k') { size <<= 10; end++; }
+        else if (*end == 'M' || *end == 'm') { size <<= 20; end++; }
+        else if (*end == 'G' || *end == 'g') { size <<= 30; end++; }
+        sizes.push_back(size);
+        if (*end == ',')
+            end++;
+        else if (*end != '\0')
+            return false;
+        p = end;
+    }
+    return !sizes.empty();
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage : %s <--app pr|bfs|cc|sssp(optional)> <--caches 32K,256K,..(optional)> <--line bytes(optional)> <--prop bytes(optional)> <--iterations n(optional)> <--source v(optional)> <--warmup f(optional)> <--hist(optional)> <--weighted(optional)> <--threads n(optional)> <--verify(optional)> <inputFile1> <orderFile ...(optional)>\n", argv[0]);
+        exit(1);
+    }
+    int i = 1;
+    for (; i < argc-1; i++){
+      char * opt = argv[i];
+      if (strcmp(opt, "-w") == 0 || strcmp(opt,"--weighted") == 0) weighted = true;
+      else if (strcmp(opt, "--hist") == 0) printHist = true;
+      else if (strcmp(opt, "--verify") == 0) verifyChecksum = true;
+      else if (strcmp(opt, "--app") == 0 && i+1 < argc-1) app = argv[++i];
+      else if (strcmp(opt, "--caches") == 0 && i+1 < argc-1)
+      {
+          if (!parseSizes(argv[++i], cacheSizes))
+          {
+              fprintf(stderr, "bad cache capacities %s, expected e.g. 32K,1M,32M\n", argv[i]);
+              exit(1);
+          }
+      }
+      else if (strcmp(opt, "--line") == 0 && i+1 < argc-1) lineSize = atoi(argv[++i]);
+      else if (strcmp(opt, "--prop") == 0 && i+1 < argc-1) propSize = atoi(argv[++i]);
+      else if (strcmp(opt, "--iterations") == 0 && i+1 < argc-1) iterations = atoi(argv[++i]);
+      else if (strcmp(opt, "--source") == 0 && i+1 < argc-1) source = atoi(argv[++i]);
+      else if (strcmp(opt, "--warmup") == 0 && i+1 < argc-1) warmup = atof(argv[++i]);
+      else if ((strcmp(opt, "-t") == 0 || strcmp(opt,"--threads") == 0) && i+1 < argc-1) numThreads = atoi(argv[++i]);
+      else break;
+    }
+    if (strcmp(app, "pr") != 0 && strcmp(app, "bfs") != 0 && strcmp(app, "cc") != 0 && strcmp(app, "sssp") != 0)
+    {
+        fprintf(stderr, "unknown app %s, expected pr, bfs, cc or sssp\n", app);
+        exit(1);
+    }
+    if (cacheSizes.empty())
+        parseSizes("32K,256K,1M,8M,32M", cacheSizes);
+    // pagerank reads doubles, the others ints
+    if (propSize == 0)
+        propSize = (strcmp(app, "pr") == 0) ? 8 : 4;
+    if (lineSize == 0)
+        lineSize = 64;
+
+    char* inFile = argv[i];
+    vector<char*> orders(argv + i + 1, argv + argc);
+
+    if (needs_wide_offsets(inFile))
+        return simulate<unsigned int, unsigned long long>(inFile, orders);
+    return simulate<unsigned int, unsigned int>(inFile, orders);
+}
+
+// the access stream of an app is a list of rows: row u touches its own property
+// (when own is set) and the property of every vertex in its list of G
+template <typename V, typename E>
+struct accessStream
+{
+    graphT<V, E>* G;
+    vector<V> rows;
+    bool own;
+    // line of the own property of u is ownBase + line of u, for pagerank's
+    // new_rank next to the contrib the neighbors read
+    unsigned long long ownBase;
+    unsigned long long numLines;
+};
+
+// rows of the graphit apps in graphit_apps/:
+// pr    DensePull: every vertex, reads contrib of its in-neighbors, writes new_rank
+// bfs   push from the frontier in discovery order, reads parent of the out-neighbors
+// cc    push rounds, the active vertices in id order, IDs[dst] min= IDs[src]
+// sssp  Bellman-Ford push rounds like cc, SP[dst] min= SP[src] + weight
+template <typename V, typename E>
+static void buildStream (graphT<V, E>* out, graphT<V, E>* in, accessStream<V, E>& S)
+{
+    V n = out->numVertex;
+    unsigned long long lines = ((unsigned long long) n * propSize + lineSize - 1) / lineSize;
+    S.numLines = lines;
+    S.ownBase = 0;
+    S.rows.clear();
+
+    if (strcmp(app, "pr") == 0)
+    {
+        S.G = in;
+        S.own = true;
+        S.ownBase = lines;
+        S.numLines = 2 * lines;
+        S.rows.resize((unsigned long long) n * iterations);
+        parallelFor(S.rows.size(), [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+            for (unsigned long long r=start; r<end; r++)
+                S.rows[r] = r % n;
+        });
+        return;
+    }
+
+    S.G = out;
+    if (strcmp(app, "bfs") == 0)
+    {
+        S.own = false;
+        vector<unsigned char> visited(n, 0);
+        if (source >= n)
+            return;
+        visited[source] = 1;
+        S.rows.push_back(source);
+        for (size_t q=0; q<S.rows.size(); q++)
+        {
+            V u = S.rows[q];
+            for (E j=out->VI[u]; j<out->VI[u+1]; j++)
+            {
+                V v = out->EI[j];
+                if (!visited[v])
+                {
+                    visited[v] = 1;
+                    S.rows.push_back(v);
+                }
+            }
+        }
+        return;
+    }
+
+    S.own = true;
+    bool sssp = strcmp(app, "sssp") == 0;
+    vector<unsigned long long> value(n);
+    vector<unsigned char> active(n, 0), next(n, 0);
+    for (V v=0; v<n; v++)
+        value[v] = sssp ? ~0ULL : v;
+    if (sssp)
+    {
+        if (source >= n)
+            return;
+        value[source] = 0;
+        active[source] = 1;
+    }
+    else
+        fill(active.begin(), active.end(), 1);
+
+    for (V round=0; round<n; round++)
+    {
+        bool any = false;
+        for (V u=0; u<n; u++)
+        {
+            if (!active[u])
+                continue;
+            S.rows.push_back(u);
+            for (E j=out->VI[u]; j<out->VI[u+1]; j++)
+            {
+                V v = out->EI[j];
+                unsigned long long w = sssp ? value[u] + ((out->weights != NULL) ? out->weights[j] : 1) : value[u];
+                if (w < value[v])
+                {
+                    value[v] = w;
+                    next[v] = 1;
+                    any = true;
+                }
+            }
+        }
+        if (!any)
+            break;
+        active.swap(next);
+        fill(next.begin(), next.end(), 0);
+    }
+}
+
+struct simResult
+{
+    unsigned long long accesses = 0, cold = 0;
+    // reuses from before the warmup of a range, longer than the stack of the range
+    unsigned long long far = 0;
+    // hist[k]: accesses with a distance in [2^k - 1, 2^(k+1) - 1) lines
+    vector<unsigned long long> hist;
+    // misses[c]: accesses missing an lru cache of cacheSizes[c] bytes
+    vector<unsigned long long> misses;
+};
+
+// calls f(line) for every access of row u, the neighbors first for the pull of
+// pagerank, the source first for the pushes
+template <typename V, typename E, typename F>
+static inline void rowLines (accessStream<V, E>& S, V u, bool pull, F f)
+{
+    graphT<V, E>* G = S.G;
+    if (S.own && !pull)
+        f(S.ownBase + (unsigned long long) u * propSize / lineSize);
+    for (E j=G->VI[u]; j<G->VI[u+1]; j++)
+        f((unsigned long long) G->EI[j] * propSize / lineSize);
+    if (S.own && pull)
+        f(S.ownBase + (unsigned long long) u * propSize / lineSize);
+}
+
+// replays the stream, cut into ranges of rows with about the same number of
+// accesses, one stack per range. a range first replays the accesses before it
+// to fill its stack. a line missing from the stack that was touched before the
+// warmup counts as far (a miss unless the cache holds all the data) instead of cold
+template <typename V, typename E>
+static simResult replay (accessStream<V, E>& S)
+{
+    graphT<V, E>* G = S.G;
+    bool pull = strcmp(app, "pr") == 0;
+    unsigned long long numRows = S.rows.size();
+    unsigned long long* rowStart = new unsigned long long [numRows+1];
+    unsigned long long* rowLen = new unsigned long long [numRows > 0 ? numRows : 1];
+    parallelFor(numRows, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long r=start; r<end; r++)
+            rowLen[r] = G->VI[S.rows[r]+1] - G->VI[S.rows[r]] + (S.own ? 1 : 0);
+    });
+    parallelPrefixSum(rowLen, rowStart, numRows);
+    delete[] rowLen;
+    unsigned long long total = rowStart[numRows];
+
+    vector<unsigned long long> cacheLines(cacheSizes.size());
+    for (size_t c=0; c<cacheSizes.size(); c++)
+        cacheLines[c] = cacheSizes[c] / lineSize;
+    // caches bigger than the data hold it all the same
+    unsigned long long warmLines = min(*max_element(cacheLines.begin(), cacheLines.end()), S.numLines);
+    unsigned long long warmAccesses = warmup * warmLines;
+
+    unsigned int numRanges = (numThreads == 0) ? 1 : numThreads;
+    // first row at or after access a
+    auto rowOf = [&](unsigned long long a) {
+        return (unsigned long long) (lower_bound(rowStart, rowStart + numRows, a) - rowStart);
+    };
+
+    // first row touching a line
+    unsigned long long* firstRow = new unsigned long long [S.numLines];
+    parallelFor(S.numLines, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long l=start; l<end; l++)
+            firstRow[l] = numRows;
+    });
+    if (numRanges > 1)
+    {
+        parallelFor(numRows, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+            for (unsigned long long r=start; r<end; r++)
+                rowLines(S, S.rows[r], pull, [&](unsigned long long line) {
+                    unsigned long long cur = firstRow[line];
+                    while (r < cur && !__sync_bool_compare_and_swap(&firstRow[line], cur, r))
+                        cur = firstRow[line];
+                });
+        });
+    }
+
+    vector<simResult> partial(numRanges);
+    parallelFor(numRanges, numRanges, [&](unsigned int tid, unsigned long long first, unsigned long long last) {
+        simResult& R = partial[tid];
+        R.hist.assign(HIST_BUCKETS, 0);
+        R.misses.assign(cacheSizes.size(), 0);
+        unsigned long long b = rowOf((total * tid) / numRanges);
+        unsigned long long e = rowOf((total * (tid+1)) / numRanges);
+        if (b >= e)
+            return;
+        unsigned long long w = rowOf((rowStart[b] > warmAccesses) ? rowStart[b] - warmAccesses : 0);
+
+        StackDist stack(S.numLines);
+        for (unsigned long long r=w; r<e; r++)
+        {
+            bool count = r >= b;
+            rowLines(S, S.rows[r], pull, [&](unsigned long long line) {
+                unsigned long long d = stack.access(line);
+                if (!count)
+                    return;
+                R.accesses++;
+                if (d == StackDist::COLD)
+                {
+                    bool far = firstRow[line] < w;
+                    if (far)
+                        R.far++;
+                    else
+                        R.cold++;
+                    for (size_t c=0; c<cacheLines.size(); c++)
+                        if (!far || cacheLines[c] < S.numLines)
+                            R.misses[c]++;
+                    return;
+                }
+                unsigned int k = 63 - __builtin_clzll(d + 1);
+                R.hist[(k < HIST_BUCKETS) ? k : HIST_BUCKETS-1]++;
+                for (size_t c=0; c<cacheLines.size(); c++)
+                    if (d >= cacheLines[c])
+                        R.misses[c]++;
+            });
+        }
+    });
+    delete[] rowStart;
+    delete[] firstRow;
+
+    simResult R;
+    R.hist.assign(HIST_BUCKETS, 0);
+    R.misses.assign(cacheSizes.size(), 0);
+    for (unsigned int t=0; t<numRanges; t++)
+    {
+        if (partial[t].hist.empty())
+            continue;
+        R.accesses += partial[t].accesses;
+        R.cold += partial[t].cold;
+        R.far += partial[t].far;
+        for (unsigned int k=0; k<HIST_BUCKETS; k++)
+            R.hist[k] += partial[t].hist[k];
+        for (size_t c=0; c<cacheSizes.size(); c++)
+            R.misses[c] += partial[t].misses[c];
+    }
+    return R;
+}
+
+// rows of G relabeled by newId, sorted like the csr the converter builds
+template <typename V, typename E>
+static void relabel (graphT<V, E>* G, V* nodeId, V* newId, graphT<V, E>* R)
+{
+    permute_csr(G, nodeId, newId, R);
+    parallelFor(R->numVertex, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        vector< pair<V, unsigned int> > pairs;
+        for (unsigned long long i=start; i<end; i++)
+        {
+            E b = R->VI[i], e = R->VI[i+1];
+            if (R->weights == NULL)
+            {
+                sort(R->EI + b, R->EI + e);
+                continue;
+            }
+            pairs.resize(e - b);
+            for (E j=b; j<e; j++)
+                pairs[j-b] = make_pair(R->EI[j], R->weights[j]);
+            sort(pairs.begin(), pairs.end());
+            for (E j=b; j<e; j++)
+            {
+                R->EI[j] = pairs[j-b].first;
+                R->weights[j] = pairs[j-b].second;
+            }
+        }
+    });
+}
+
+template <typename V, typename E>
+int simulate (char* inFile, vector<char*>& orderFiles)
+{
+    graphT<V, E> G1, G2;
+
+    // read csr file, a .bcsr input also brings the reverse csr along
+    if (read_csr(inFile, &G1, &G2)==-1)
+        exit(1);
+
+    printf("file reading done. Num vertices = %d and numEdges = %llu\n", G1.numVertex, (unsigned long long) G1.numEdges);
+
+    if (G2.VI == NULL)
+        createReverseCSR(&G1, &G2, G1.numVertex);
+
+    V n = G1.numVertex;
+    if (orderFiles.empty())
+        orderFiles.push_back(NULL);
+
+    printf("order, accesses, cold");
+    for (size_t c=0; c<cacheSizes.size(); c++)
+        printf(", miss ratio %lluK", cacheSizes[c] >> 10);
+    printf(", time\n");
+
+    V* newId = new V [n];
+    V* nodeId = new V [n];
+    for (size_t f=0; f<orderFiles.size(); f++)
+    {
+        vector<V> order;
+        if (orderFiles[f] != NULL && read_new_order(orderFiles[f], order) < 0)
+            exit(1);
+
+        struct timeval start, end;
+        gettimeofday(&start, NULL);
+
+        if (!orderNewIds(&G1, order, newId))
+        {
+            fprintf(stderr, "%s is not an order of the vertices of %s\n", orderFiles[f], inFile);
+            exit(1);
+        }
+        parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+            for (unsigned long long v=start; v<end; v++)
+                nodeId[newId[v]] = v;
+        });
+        graphT<V, E> out, in;
+        relabel(&G1, nodeId, newId, &out);
+        relabel(&G2, nodeId, newId, &in);
+
+        accessStream<V, E> S;
+        buildStream(&out, &in, S);
+        simResult R = replay(S);
+        gettimeofday(&end, NULL);
+
+        const char* name = (orderFiles[f] != NULL) ? orderFiles[f] : inFile;
+        printf("%s, %llu, %llu", name, R.accesses, R.cold);
+        for (size_t c=0; c<cacheSizes.size(); c++)
+            printf(", %lf", (R.accesses == 0) ? 0 : (double) R.misses[c] / R.accesses);
+        printf(", %lf\n", (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec)/1e6);
+        if (printHist)
+        {
+            // bucket k holds the reuse distances in [2^k - 1, 2^(k+1) - 1) lines
+            printf("%s histogram", name);
+            unsigned int top = HIST_BUCKETS;
+            while (top > 0 && R.hist[top-1] == 0)
+                top--;
+            for (unsigned int k=0; k<top; k++)
+                printf(", %llu", R.hist[k]);
+            printf(", far %llu, cold %llu\n", R.far, R.cold);
+        }
+
+        freeMem(&out);
+        freeMem(&in);
+    }
+
+    delete[] newId;
+    delete[] nodeId;
+    freeMem(&G1);
+    freeMem(&G2);
+
+    return 0;
+}
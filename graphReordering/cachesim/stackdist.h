@@ -0,0 +1,97 @@
+#ifndef STACKDIST_HEADER_INCL
+#define STACKDIST_HEADER_INCL
+
+#include <vector>
+
+// lru stack distances with a partial sum tree over the access times, the algorithm
+// of gem5's StackDistCalc (mem/stack_dist_calc.hh): every line has a leaf set at the
+// time of its last access, the distance of an access is the sum of the leaves after
+// the previous access of the line. the tree is a fenwick array over a window of
+// times instead of maps of nodes, when the window is full the live times are
+// renumbered in order. lines are dense ids in [0, numLines)
+class StackDist
+{
+  public:
+    static const unsigned long long COLD = ~0ULL;
+
+    StackDist (unsigned long long numLines)
+        : last(numLines, 0), now(0), live(0)
+    {
+        cap = 2 * numLines;
+        if (cap < 1024)
+            cap = 1024;
+        tree.assign(cap, 0);
+        lineAt.assign(cap, 0);
+    }
+
+    // distinct lines touched since the last access to line (0: the line was the
+    // last one touched), COLD for the first access
+    unsigned long long access (unsigned long long line)
+    {
+        unsigned long long dist = COLD;
+        if (last[line] != 0)
+        {
+            unsigned long long t = last[line] - 1;
+            dist = live - prefix(t);
+            add(t, -1);
+            last[line] = 0;
+        }
+        else
+            live++;
+        if (now == cap)
+            compact();
+        add(now, 1);
+        lineAt[now] = line;
+        last[line] = now + 1;
+        now++;
+        return dist;
+    }
+
+  private:
+    // leaves set in [0, t]
+    unsigned long long prefix (unsigned long long t) const
+    {
+        unsigned long long sum = 0;
+        for (long long i=t; i>=0; i=(i & (i+1)) - 1)
+            sum += tree[i];
+        return sum;
+    }
+
+    void add (unsigned long long t, int d)
+    {
+        for (unsigned long long i=t; i<cap; i|=i+1)
+            tree[i] += d;
+    }
+
+    // live lines get the times [0, live) in the order of their last access
+    void compact ()
+    {
+        unsigned long long k = 0;
+        for (unsigned long long t=0; t<now; t++)
+        {
+            unsigned long long line = lineAt[t];
+            if (last[line] == t + 1)
+            {
+                lineAt[k] = line;
+                last[line] = ++k;
+            }
+        }
+        for (unsigned long long i=0; i<cap; i++)
+            tree[i] = (i < k) ? 1 : 0;
+        for (unsigned long long i=0; i<cap; i++)
+        {
+            unsigned long long j = i | (i+1);
+            if (j < cap)
+                tree[j] += tree[i];
+        }
+        now = k;
+    }
+
+    // time + 1 of the last access of a line, 0 if it was not accessed yet
+    std::vector<unsigned int> last;
+    std::vector<unsigned int> tree;
+    std::vector<unsigned int> lineAt;
+    unsigned long long cap, now, live;
+};
+
+#endif
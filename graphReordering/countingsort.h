@@ -0,0 +1,146 @@
+#ifndef COUNTINGSORT_HEADER_INCL
+#define COUNTINGSORT_HEADER_INCL
+
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include "parallel.h"
+
+// stable parallel counting sort
+// out[] receives in[] ordered by key[i] (the key of in[i]), keys are in [0, maxKey]
+// every thread histograms its own slice of the input, the per thread offsets
+// come from one prefix sum over (key, thread) so the scatter needs no atomics
+template <typename K, typename T>
+void parallelCountingSort (const K* key, K maxKey, const T* in, T* out, unsigned long long n, bool descending = false)
+{
+    unsigned long long numKeys = (unsigned long long) maxKey + 1;
+    // keep the histograms smaller than the slices they count
+    unsigned long long numChunks = n / numKeys;
+    if (numChunks > numThreads)
+        numChunks = numThreads;
+    if (numChunks == 0)
+        numChunks = 1;
+
+    unsigned long long* hist = new unsigned long long [numChunks * numKeys]();
+    parallelFor(n, numChunks, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        unsigned long long* h = hist + tid * numKeys;
+        for (unsigned long long i=start; i<end; i++)
+            h[key[i]]++;
+    });
+
+    // bucket b holds key (descending ? maxKey-b : b), within a bucket chunks keep input order
+    unsigned long long* bucketSize = new unsigned long long [numKeys];
+    unsigned long long* bucketStart = new unsigned long long [numKeys+1];
+    parallelFor(numKeys, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long b=start; b<end; b++)
+        {
+            unsigned long long k = descending ? numKeys-1-b : b;
+            unsigned long long sum = 0;
+            for (unsigned long long c=0; c<numChunks; c++)
+                sum += hist[c * numKeys + k];
+            bucketSize[b] = sum;
+        }
+    });
+    parallelPrefixSum(bucketSize, bucketStart, numKeys);
+    parallelFor(numKeys, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long b=start; b<end; b++)
+        {
+            unsigned long long k = descending ? numKeys-1-b : b;
+            unsigned long long offset = bucketStart[b];
+            for (unsigned long long c=0; c<numChunks; c++)
+            {
+                unsigned long long cnt = hist[c * numKeys + k];
+                hist[c * numKeys + k] = offset;
+                offset += cnt;
+            }
+        }
+    });
+
+    parallelFor(n, numChunks, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        unsigned long long* h = hist + tid * numKeys;
+        for (unsigned long long i=start; i<end; i++)
+            out[h[key[i]]++] = in[i];
+    });
+
+    delete[] hist;
+    delete[] bucketSize;
+    delete[] bucketStart;
+}
+
+// largest of f(i) over [0, n), 0 when n is 0
+template <typename K, typename F>
+K parallelMax (unsigned long long n, F f)
+{
+    unsigned int numChunks = (numThreads == 0) ? 1 : numThreads;
+    K* chunkMax = new K [numChunks]();
+    parallelFor(n, numChunks, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        K m = 0;
+        for (unsigned long long i=start; i<end; i++)
+            if (f(i) > m)
+                m = f(i);
+        chunkMax[tid] = m;
+    });
+    K maxKey = 0;
+    for (unsigned int c=0; c<numChunks; c++)
+        if (chunkMax[c] > maxKey)
+            maxKey = chunkMax[c];
+    delete[] chunkMax;
+    return maxKey;
+}
+
+// stable sort of the ids in list[0, n) by keyOf[id], in place
+template <typename K, typename T>
+void parallelCountingSortBy (T* list, unsigned long long n, const K* keyOf, bool descending = false)
+{
+    K* key = new K [n];
+    T* sorted = new T [n];
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long i=start; i<end; i++)
+            key[i] = keyOf[list[i]];
+    });
+    K maxKey = parallelMax<K>(n, [&](unsigned long long i) { return key[i]; });
+    parallelCountingSort(key, maxKey, list, sorted, n, descending);
+    memcpy(list, sorted, n * sizeof(T));
+    delete[] key;
+    delete[] sorted;
+}
+
+// stable sort of key[0, n) in place, val[i] moves along with key[i]
+// replaces the old mergeSort(key, val, 0, n-1) of pH and BR, which sorted
+// the costs highest first
+template <typename K, typename T>
+void parallelSortPairs (K* key, T* val, unsigned long long n, bool descending = true)
+{
+    K maxKey = parallelMax<K>(n, [&](unsigned long long i) { return key[i]; });
+    K* sortedKey = new K [n];
+    T* sortedVal = new T [n];
+    parallelCountingSort(key, maxKey, val, sortedVal, n, descending);
+    parallelCountingSort(key, maxKey, key, sortedKey, n, descending);
+    memcpy(key, sortedKey, n * sizeof(K));
+    memcpy(val, sortedVal, n * sizeof(T));
+    delete[] sortedKey;
+    delete[] sortedVal;
+}
+
+// sorts arr[0, n) in place, replaces mergeSortWOkey
+// counting sort when the values are dense enough, a comparison sort otherwise
+// (short or sparse lists such as the neighbors of one BR block)
+template <typename T>
+void sortValues (T* arr, unsigned long long n, bool descending = true)
+{
+    T maxKey = (n < 4096) ? 0 : parallelMax<T>(n, [&](unsigned long long i) { return arr[i]; });
+    if (n < 4096 || (unsigned long long) maxKey >= 4 * n)
+    {
+        if (descending)
+            std::sort(arr, arr + n, std::greater<T>());
+        else
+            std::sort(arr, arr + n);
+        return;
+    }
+    T* sorted = new T [n];
+    parallelCountingSort(arr, maxKey, arr, sorted, n, descending);
+    memcpy(arr, sorted, n * sizeof(T));
+    delete[] sorted;
+}
+
+#endif
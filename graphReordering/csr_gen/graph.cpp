@@ -1,113 +0,0 @@
-#include "graph.h"
-
-int read_csr (char* filename, graph* G)
-{
-    FILE* graphFile = fopen(filename, "rb");
-    if (graphFile == NULL)
-    {
-        fputs("file error", stderr);
-        return -1;
-    }
-    fread (&(G->numVertex), sizeof(unsigned int), 1, graphFile);
-    fread (&(G->numEdges), sizeof(unsigned int), 1, graphFile);
-
-
-    G->VI = new unsigned int[G->numVertex];
-
-    fread (G->VI, sizeof(unsigned int), G->numVertex, graphFile);
-    if (feof(graphFile))
-    {
-        delete[] G->VI;
-        printf("unexpected end of file while reading vertices\n");
-        return -1;
-    }
-    else if (ferror(graphFile))
-    {
-        delete[] G->VI;
-        printf("error reading file\n");
-        return -1;
-    }
-
-    G->EI = new unsigned int[G->numEdges];
-    fread (G->EI, sizeof(unsigned int), G->numEdges, graphFile);
-    if (feof(graphFile))
-    {
-        delete[] G->VI;
-        delete[] G->EI;
-        printf("unexpected end of file while reading edges\n");
-        return -1;
-    }
-    else if (ferror(graphFile))
-    {
-        delete[] G->VI;
-        delete[] G->EI;
-        printf("error reading file\n");
-        return -1;
-    }
-    fclose(graphFile);
-    return 1;
-}
-
-
-void printGraph (graph* G)
-{
-    printf("number of vertices are %d\n", G->numVertex);
-    printf("number of edges are %d\n", G->numEdges);
-    for (int i=0; i<G->numVertex; i++)
-        printf("%d ", G->VI[i]);
-    printf("\n");
-    for (int i=0; i<G->numEdges; i++)
-        printf("%d ", G->EI[i]);
-    printf("\n");
-}
-
-
-void write_csr (char* filename, graph* G)
-{
-    FILE* fp = fopen(filename, "wb");
-    if (fp == NULL)
-    {
-        fputs("file error", stderr);
-        return;
-    }
-    fwrite(&G->numVertex, sizeof(unsigned int), 1, fp); 
-    fwrite(&G->numEdges, sizeof(unsigned int), 1, fp); 
-    fwrite(G->VI, sizeof(unsigned int), G->numVertex, fp); 
-    fwrite(G->EI, sizeof(unsigned int), G->numEdges, fp); 
-    fclose(fp); 
-}
-
-void createReverseCSR(graph* G1, graph* G2)
-{
-    G2->numVertex = G1->numVertex;
-    G2->numEdges = G1->numEdges;
-    G2->VI = new unsigned int[G1->numVertex]();
-    G2->EI = new unsigned int[G1->numEdges]; 
-
-    for (unsigned int i=0; i<G1->numEdges; i++)
-    {
-        if (G1->EI[i] < G1->numVertex-1)
-            G2->VI[G1->EI[i]+1]++;
-    }
-    for (int i=1; i<G1->numVertex; i++)
-        G2->VI[i] += G2->VI[i-1];
-    int* tempId = new int [G1->numVertex]();
-    for (unsigned int i=0; i<G1->numVertex; i++)
-    {
-        unsigned int maxId = (i==G1->numVertex-1) ? G1->numEdges : G1->VI[i+1];
-        for (unsigned int j=G1->VI[i]; j<maxId; j++)
-        {
-            G2->EI[G2->VI[G1->EI[j]] + tempId[G1->EI[j]]] = i;
-            tempId[G1->EI[j]]++;
-        } 
-    }
-    delete[] tempId;
-}
-
-
-void freeMem (graph* G)
-{
-    delete[] G->VI;
-    delete[] G->EI;
-}
-
@@ -2,95 +2,113 @@
 #include <vector>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <sys/time.h>
 #include <unordered_map>
+#include "parallel.h"
 #ifndef GRAPH_HEADER_INCL
 #include "graph.h"
-#include "sort.h"
 #endif
 
 #define DEBUG 1
 
 using namespace std;
 
+bool weighted = false, maintain = false, indegree = false;
 
+template <typename V, typename E>
+int convert (char*, char*, bool);
 
 int main(int argc, char** argv)
 {
+    bool legacy = false;
 
-    // 2 files for 2 different CSR representations
-    if (argc != 3)
+    if (argc < 3)
     {
-        printf("Usage : %s <inputFile1> <outputFile>\n", argv[0]);
+        printf("Usage : %s <--weighted(optional)> <--legacy(optional)> <--indegree(optional)> <--threads n(optional)> <--verify(optional)> <inputFile1> <outputFile>\n", argv[0]);
         exit(1);
     }
+    for (int i = 1; i < argc-2; i++){
+      char * opt = argv[i];
+      if (strcmp(opt, "-w") == 0 || strcmp(opt,"--weighted") == 0) weighted = true;
+      else if (strcmp(opt, "-l") == 0 || strcmp(opt,"--legacy") == 0) legacy = true;
+      else if (strcmp(opt, "-i") == 0 || strcmp(opt,"--indegree") == 0) indegree = true;
+      else if ((strcmp(opt, "-t") == 0 || strcmp(opt,"--threads") == 0) && i+1 < argc-2) numThreads = atoi(argv[++i]);
+      else if (strcmp(opt, "--verify") == 0) verifyChecksum = true;
+    }
 
-    // graph objects
-    // edge list
-    std::vector<int> src;
-    std::vector<int> dst;
-
-    unsigned int numEdgesRead = 0;
-
-    FILE* fp = fopen (argv[1], "r");
-    if (fp == NULL)
+    // a .bcsr always holds both directions
+    if (indegree && !legacy)
     {
-        fputs("file error", stderr);
-        return -1;
+        fputs("--indegree only applies to the legacy layout (-l)\n", stderr);
+        exit(1);
     }
 
-    int srcVal, dstVal;
-    int numVertex = 0;
-    while(!feof(fp))
+    // 64-bit edge offsets only when the graph needs them
+    if (needs_wide_offsets(argv[argc-2]))
+        return convert<unsigned int, unsigned long long>(argv[argc-2], argv[argc-1], legacy);
+    return convert<unsigned int, unsigned int>(argv[argc-2], argv[argc-1], legacy);
+}
+
+template <typename V, typename E>
+int convert (char* inFile, char* outFile, bool legacy)
+{
+    // graph objects
+    graphT<V, E> G1, G2;
+
+    if (legacy && !is_bcsr(inFile))
     {
-        if(fscanf(fp, "%d", &srcVal) <= 0)
-            break;
-        fscanf(fp, "%d", &dstVal);
-        numVertex = (srcVal > numVertex) ? srcVal : numVertex;
-        numVertex = (dstVal > numVertex) ? dstVal : numVertex;
-        if (srcVal != dstVal)
+        // as the old csr_gen: self loops are dropped and the ids are not compacted
+        V* src;
+        V* dst;
+        unsigned int* weights;
+        E numEdgesRead;
+        V numVertex;
+        if (read_edge_list(inFile, src, dst, weights, numEdgesRead, numVertex) < 0)
+            exit(1);
+        E numEdges = 0;
+        for (E i=0; i<numEdgesRead; i++)
         {
-            src.push_back(srcVal);
-            dst.push_back(dstVal);
-            numEdgesRead++;
+            if (src[i] == dst[i])
+                continue;
+            src[numEdges] = src[i];
+            dst[numEdges] = dst[i];
+            if (weights != NULL)
+                weights[numEdges] = weights[i];
+            numEdges++;
         }
+        build_csr(src, dst, weights, numEdges, numVertex, &G1);
+        delete[] src;
+        delete[] dst;
+        delete[] weights;
     }
-    fclose(fp);
-
-    numVertex++;
-
-    int* deg = new int [numVertex]();
-
-    
-    for (int i=0; i<numEdgesRead; i++)
-        deg [src[i]]++;
-
-
-    graph G1;
-    G1.numVertex = numVertex;
-    G1.numEdges = numEdgesRead;
-    G1.VI = new unsigned int [numVertex]();
-    G1.EI = new unsigned int [numEdgesRead]();
-
-    for (int i=1; i<numVertex; i++)
-        G1.VI[i] = G1.VI[i-1] + deg [i-1];
+    // the input can be a text edge list or a .bcsr file,
+    // either way G1 is the out-csr
+    else if (read_csr(inFile, &G1, &G2)==-1)
+        exit(1);
 
-    for (int i=0; i<numVertex; i++)
-        deg [i] = 0;
+#ifdef DEBUG
+    printf("file reading done. Num vertices = %d and numEdges = %llu\n", G1.numVertex, (unsigned long long) G1.numEdges);
+#endif
 
-    for (unsigned int i=0; i<numEdgesRead; i++)
+    if (legacy)
     {
-        G1.EI[G1.VI[src[i]] + deg [src[i]]] = dst[i];
-        deg [src[i]]++;
+        // numVertex, numEdges, VI, EI as read by the example algorithms,
+        // the in-edges of every vertex with --indegree
+        if (write_csr(outFile, &G1) < 0)
+            exit(1);
+    }
+    else
+    {
+        if (G2.VI == NULL)
+            createReverseCSR(&G1, &G2, G1.numVertex);
+        if (write_bcsr(outFile, &G1, &G2) < 0)
+            exit(1);
     }
 
-    write_csr(argv[2], &G1); 
-
-
-    delete[] deg ;
     freeMem(&G1);
+    freeMem(&G2);
 
     return 0;
 }
-
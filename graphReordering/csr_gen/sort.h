@@ -1,11 +0,0 @@
-#include <iostream>
-#include <stdio.h>
-#include <stdlib.h>
-
-void merge(int*, int*, int, int, int);
-
-void mergeSort (int*, int*, int, int); 
-
-void mergeWOkey (unsigned int*, int, int, int);
-
-void mergeSortWOkey (unsigned int*, int, int);
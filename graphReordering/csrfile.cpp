@@ -0,0 +1,294 @@
+#include "csrfile.h"
+#include "parallel.h"
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define FNV_OFFSET 1469598103934665603ULL
+#define FNV_PRIME 1099511628211ULL
+#define CHECKSUM_BLOCK (1ULL << 20)
+
+static uint64_t checksum_block (const unsigned char* p, size_t n)
+{
+    uint64_t h = FNV_OFFSET;
+    size_t i = 0;
+    for (; i+8 <= n; i+=8)
+    {
+        uint64_t word;
+        memcpy(&word, p+i, 8);
+        h ^= word;
+        h *= FNV_PRIME;
+    }
+    for (; i<n; i++)
+    {
+        h ^= p[i];
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+// blocks are hashed in parallel and folded in order,
+// so the result doesn't depend on the thread count
+static uint64_t checksum (const void* data, uint64_t bytes)
+{
+    const unsigned char* p = (const unsigned char*) data;
+    uint64_t numBlocks = (bytes + CHECKSUM_BLOCK - 1) / CHECKSUM_BLOCK;
+    uint64_t* blockHash = new uint64_t [numBlocks];
+    parallelFor(numBlocks, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long b=start; b<end; b++)
+        {
+            uint64_t len = (b == numBlocks-1) ? bytes - b*CHECKSUM_BLOCK : CHECKSUM_BLOCK;
+            blockHash[b] = checksum_block(p + b*CHECKSUM_BLOCK, len);
+        }
+    });
+    uint64_t h = FNV_OFFSET;
+    for (uint64_t b=0; b<numBlocks; b++)
+        h = (h * FNV_PRIME) ^ blockHash[b];
+    delete[] blockHash;
+    return h;
+}
+
+static uint64_t header_checksum (const bcsrHeader* H)
+{
+    bcsrHeader tmp = *H;
+    tmp.headerChecksum = 0;
+    return checksum_block((const unsigned char*) &tmp, sizeof(bcsrHeader));
+}
+
+static uint64_t page_align (uint64_t bytes)
+{
+    return (bytes + BCSR_PAGE_SIZE - 1) / BCSR_PAGE_SIZE * BCSR_PAGE_SIZE;
+}
+
+// entries and width of every section for the counts of H, and whether the flags
+// of H call for it
+static void section_layout (const bcsrHeader* H, uint64_t* entries, uint64_t* width, bool* present)
+{
+    entries[BCSR_OUT_VI] = H->numVertex+1; width[BCSR_OUT_VI] = H->offsetBytes;
+    entries[BCSR_OUT_EI] = H->numEdges;    width[BCSR_OUT_EI] = H->idBytes;
+    entries[BCSR_OUT_W] = H->numEdges;     width[BCSR_OUT_W] = sizeof(uint32_t);
+    entries[BCSR_IN_VI] = H->numVertex+1;  width[BCSR_IN_VI] = H->offsetBytes;
+    entries[BCSR_IN_EI] = H->numEdges;     width[BCSR_IN_EI] = H->idBytes;
+    entries[BCSR_IN_W] = H->numEdges;      width[BCSR_IN_W] = sizeof(uint32_t);
+    entries[BCSR_ORIG_ID] = H->numVertex;  width[BCSR_ORIG_ID] = H->idBytes;
+
+    bool in = (H->flags & BCSR_IN_CSR), w = (H->flags & BCSR_WEIGHTS);
+    present[BCSR_OUT_VI] = true;
+    present[BCSR_OUT_EI] = true;
+    present[BCSR_OUT_W] = w;
+    present[BCSR_IN_VI] = in;
+    present[BCSR_IN_EI] = in;
+    present[BCSR_IN_W] = in && w;
+    present[BCSR_ORIG_ID] = (H->flags & BCSR_ORIG_IDS);
+}
+
+bool is_bcsr (const char* filename)
+{
+    FILE* fp = fopen(filename, "rb");
+    if (fp == NULL)
+        return false;
+    char magic[8];
+    bool match = (fread(magic, 1, 8, fp) == 8) && (memcmp(magic, BCSR_MAGIC, 8) == 0);
+    fclose(fp);
+    return match;
+}
+
+int open_bcsr (const char* filename, bcsrFile* F, bool verify)
+{
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        fputs("file error", stderr);
+        return -1;
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) < 0 || (size_t)sb.st_size < BCSR_PAGE_SIZE)
+    {
+        fputs("bcsr: file too small for a header\n", stderr);
+        close(fd);
+        return -1;
+    }
+    F->size = sb.st_size;
+    F->base = mmap(NULL, F->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (F->base == MAP_FAILED)
+    {
+        fputs("bcsr: mmap error\n", stderr);
+        return -1;
+    }
+    F->refs = 1;
+    memcpy(&F->header, F->base, sizeof(bcsrHeader));
+    bcsrHeader* H = &F->header;
+
+    if (memcmp(H->magic, BCSR_MAGIC, 8) != 0)
+    {
+        fputs("bcsr: bad magic\n", stderr);
+        close_bcsr(F);
+        return -1;
+    }
+    if (H->version != BCSR_VERSION)
+    {
+        fprintf(stderr, "bcsr: unsupported version %u (expected %u)\n", H->version, BCSR_VERSION);
+        close_bcsr(F);
+        return -1;
+    }
+    if (H->headerChecksum != header_checksum(H))
+    {
+        fputs("bcsr: header checksum mismatch\n", stderr);
+        close_bcsr(F);
+        return -1;
+    }
+
+    // every count has to fit in the file before it is multiplied by a width
+    if ((H->offsetBytes != sizeof(uint32_t) && H->offsetBytes != sizeof(uint64_t)) ||
+        H->idBytes != sizeof(uint32_t) || H->numVertex >= F->size || H->numEdges > F->size)
+    {
+        fputs("bcsr: bad counts or widths in the header\n", stderr);
+        close_bcsr(F);
+        return -1;
+    }
+    uint64_t entries[BCSR_NUM_SECTIONS];
+    uint64_t width[BCSR_NUM_SECTIONS];
+    bool present[BCSR_NUM_SECTIONS];
+    section_layout(H, entries, width, present);
+
+    for (unsigned int s=0; s<BCSR_NUM_SECTIONS; s++)
+    {
+        F->section[s] = NULL;
+        // a section the flags call for has exactly the size of its entries, the
+        // others are absent (an empty graph has empty EI sections, they stay NULL)
+        uint64_t bytes = present[s] ? entries[s] * width[s] : 0;
+        if (H->sectionBytes[s] != bytes)
+        {
+            fprintf(stderr, "bcsr: section %u holds %llu bytes, the header calls for %llu\n", s,
+                    (unsigned long long) H->sectionBytes[s], (unsigned long long) bytes);
+            close_bcsr(F);
+            return -1;
+        }
+        if (bytes == 0)
+            continue;
+        if (H->sectionOffset[s] % BCSR_PAGE_SIZE != 0 || H->sectionOffset[s] < BCSR_PAGE_SIZE ||
+            H->sectionOffset[s] > F->size || H->sectionBytes[s] > F->size - H->sectionOffset[s])
+        {
+            fprintf(stderr, "bcsr: section %u out of bounds\n", s);
+            close_bcsr(F);
+            return -1;
+        }
+        F->section[s] = (char*) F->base + H->sectionOffset[s];
+        if (verify && checksum(F->section[s], H->sectionBytes[s]) != H->sectionChecksum[s])
+        {
+            fprintf(stderr, "bcsr: checksum mismatch in section %u\n", s);
+            close_bcsr(F);
+            return -1;
+        }
+    }
+    return 1;
+}
+
+void close_bcsr (bcsrFile* F)
+{
+    if (F->base != NULL && F->base != MAP_FAILED)
+        munmap(F->base, F->size);
+    F->base = NULL;
+    F->size = 0;
+}
+
+int write_bcsr_file (const char* filename, uint64_t numVertex, uint64_t numEdges, uint32_t offsetBytes, const void* const* sections)
+{
+    bcsrHeader H;
+    memset(&H, 0, sizeof(bcsrHeader));
+    memcpy(H.magic, BCSR_MAGIC, 8);
+    H.version = BCSR_VERSION;
+    H.numVertex = numVertex;
+    H.numEdges = numEdges;
+    H.offsetBytes = offsetBytes;
+    H.idBytes = sizeof(uint32_t);
+
+    if (sections[BCSR_OUT_VI] == NULL || sections[BCSR_OUT_EI] == NULL)
+    {
+        fputs("bcsr: out csr is required\n", stderr);
+        return -1;
+    }
+    if (sections[BCSR_OUT_W] != NULL)
+        H.flags |= BCSR_WEIGHTS;
+    if (sections[BCSR_IN_VI] != NULL && sections[BCSR_IN_EI] != NULL)
+        H.flags |= BCSR_IN_CSR;
+    if (sections[BCSR_ORIG_ID] != NULL)
+        H.flags |= BCSR_ORIG_IDS;
+
+    uint64_t entries[BCSR_NUM_SECTIONS];
+    uint64_t width[BCSR_NUM_SECTIONS];
+    bool present[BCSR_NUM_SECTIONS];
+    section_layout(&H, entries, width, present);
+    if (present[BCSR_IN_W] && sections[BCSR_IN_W] == NULL)
+    {
+        fputs("bcsr: in csr of a weighted graph needs its weights\n", stderr);
+        return -1;
+    }
+
+    uint64_t offset = BCSR_PAGE_SIZE;
+    for (unsigned int s=0; s<BCSR_NUM_SECTIONS; s++)
+    {
+        if (!present[s])
+            continue;
+        H.sectionOffset[s] = offset;
+        H.sectionBytes[s] = entries[s] * width[s];
+        H.sectionChecksum[s] = checksum(sections[s], H.sectionBytes[s]);
+        offset = page_align(offset + H.sectionBytes[s]);
+    }
+    H.headerChecksum = header_checksum(&H);
+
+    FILE* fp = fopen(filename, "wb");
+    if (fp == NULL)
+    {
+        fputs("file error", stderr);
+        return -1;
+    }
+    char* pad = new char [BCSR_PAGE_SIZE]();
+    fwrite(&H, sizeof(bcsrHeader), 1, fp);
+    fwrite(pad, 1, BCSR_PAGE_SIZE - sizeof(bcsrHeader), fp);
+    uint64_t written = BCSR_PAGE_SIZE;
+    for (unsigned int s=0; s<BCSR_NUM_SECTIONS; s++)
+    {
+        if (H.sectionBytes[s] == 0)
+            continue;
+        fwrite(sections[s], 1, H.sectionBytes[s], fp);
+        written += H.sectionBytes[s];
+        uint64_t aligned = page_align(written);
+        fwrite(pad, 1, aligned - written, fp);
+        written = aligned;
+    }
+    delete[] pad;
+    if (ferror(fp))
+    {
+        fputs("bcsr: write error\n", stderr);
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+    return 1;
+}
+
+void bcsr_prefetch (const void* begin, size_t bytes)
+{
+    if (bytes == 0)
+        return;
+    uintptr_t page = sysconf(_SC_PAGESIZE);
+    uintptr_t first = (uintptr_t) begin & ~(page - 1);
+    uintptr_t last = ((uintptr_t) begin + bytes + page - 1) & ~(page - 1);
+    madvise((void*) first, last - first, MADV_WILLNEED);
+    volatile unsigned char sink = 0;
+    for (uintptr_t p=first; p<last; p+=page)
+        sink += *(const unsigned char*) p;
+}
+
+void bcsr_release (const void* begin, size_t bytes)
+{
+    uintptr_t page = sysconf(_SC_PAGESIZE);
+    uintptr_t first = ((uintptr_t) begin + page - 1) & ~(page - 1);
+    uintptr_t last = ((uintptr_t) begin + bytes) & ~(page - 1);
+    if (last > first)
+        madvise((void*) first, last - first, MADV_DONTNEED);
+}
@@ -0,0 +1,89 @@
+#ifndef CSRFILE_HEADER_INCL
+#define CSRFILE_HEADER_INCL
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// binary CSR container (.bcsr)
+//
+// page 0 holds the header, every section starts on its own page so it
+// can be used in place straight out of the mapping. all values are little endian.
+//
+//   section      entries          width
+//   OUT_VI       numVertex+1      offsetBytes (4 or 8)
+//   OUT_EI       numEdges         idBytes (4)
+//   OUT_W        numEdges         4, weight of OUT_EI[j]       (BCSR_WEIGHTS)
+//   IN_VI        numVertex+1      offsetBytes                  (BCSR_IN_CSR)
+//   IN_EI        numEdges         idBytes                      (BCSR_IN_CSR)
+//   IN_W         numEdges         4, weight of IN_EI[j]        (BCSR_IN_CSR | BCSR_WEIGHTS)
+//   ORIG_ID      numVertex        idBytes, id in the input edge list (BCSR_ORIG_IDS)
+//
+// out-lists keep the edge order of the input, in-lists are sorted. every section carries a checksum, the header
+// checksum is always verified on open, the section checksums only on request.
+
+#define BCSR_MAGIC "GRBCSR\0"
+#define BCSR_VERSION 1
+#define BCSR_PAGE_SIZE 4096
+
+#define BCSR_WEIGHTS    0x1
+#define BCSR_IN_CSR     0x2
+#define BCSR_ORIG_IDS   0x4
+
+enum bcsrSection
+{
+    BCSR_OUT_VI = 0,
+    BCSR_OUT_EI,
+    BCSR_OUT_W,
+    BCSR_IN_VI,
+    BCSR_IN_EI,
+    BCSR_IN_W,
+    BCSR_ORIG_ID,
+    BCSR_NUM_SECTIONS
+};
+
+typedef struct bcsrHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t numVertex;
+    uint64_t numEdges;
+    uint32_t offsetBytes;
+    uint32_t idBytes;
+    uint64_t sectionOffset[BCSR_NUM_SECTIONS];
+    uint64_t sectionBytes[BCSR_NUM_SECTIONS];
+    uint64_t sectionChecksum[BCSR_NUM_SECTIONS];
+    uint64_t headerChecksum;
+} bcsrHeader;
+
+// an open, memory mapped .bcsr file
+// section[s] points into the mapping, NULL if the section is absent
+typedef struct bcsrFile
+{
+    bcsrHeader header;
+    void* base;
+    size_t size;
+    void* section[BCSR_NUM_SECTIONS];
+    unsigned int refs;
+} bcsrFile;
+
+bool is_bcsr (const char*);
+
+// maps the file copy-on-write, so callers may modify sections in place
+int open_bcsr (const char*, bcsrFile*, bool);
+
+void close_bcsr (bcsrFile*);
+
+// out-of-core helpers for a part of a mapped section, widened / narrowed to whole pages
+// prefetch asks the kernel to read the pages and touches them, release drops them
+// again (they are read back from the file on the next access, so only release
+// what was not modified in place)
+void bcsr_prefetch (const void*, size_t);
+void bcsr_release (const void*, size_t);
+
+// sections[s] == NULL leaves the section out, VI sections hold numVertex+1 entries
+int write_bcsr_file (const char*, uint64_t, uint64_t, uint32_t, const void* const*);
+
+#endif
@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <string.h>
+#include "parallel.h"
+#include "countingsort.h"
+#include "degorder.h"
+
+using namespace std;
+
+template <typename T>
+static inline void atomicMin (T* addr, T val)
+{
+    T cur = *addr;
+    while (val < cur && !__sync_bool_compare_and_swap(addr, cur, val))
+        cur = *addr;
+}
+
+template <typename V, typename E>
+void degreeOrder (const V* src, const V* dst, E numEdges, V numVertex, bool hub, V* order)
+{
+    // key is the end of an edge whose degree is counted
+    const V* key = indegree ? dst : src;
+    const V* other = indegree ? src : dst;
+
+    // firstKey / firstOther: first edge in which a vertex is the key / the other end,
+    // numEdges if there is none
+    V* degree = new V [numVertex];
+    E* firstKey = new E [numVertex];
+    E* firstOther = new E [numVertex];
+    parallelFor(numVertex, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long v=start; v<end; v++)
+        {
+            degree[v] = 0;
+            firstKey[v] = numEdges;
+            firstOther[v] = numEdges;
+        }
+    });
+    parallelFor(numEdges, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long j=start; j<end; j++)
+        {
+            __sync_fetch_and_add(&degree[key[j]], 1);
+            atomicMin(&firstKey[key[j]], (E) j);
+            atomicMin(&firstOther[other[j]], (E) j);
+        }
+    });
+
+    V n = 0;
+    if (!hub)
+    {
+        // vertices with edges by first appearance, sorted by degree,
+        // then the ones only seen as the other end, by first appearance
+        V* slot = new V [numEdges];
+        parallelFor(numVertex, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+            for (unsigned long long v=start; v<end; v++)
+                if (firstKey[v] < numEdges)
+                    slot[firstKey[v]] = v;
+        });
+        n = parallelPack(numEdges, [&](unsigned long long j) { return firstKey[key[j]] == j; },
+                         [&](unsigned long long j) { return slot[j]; }, order);
+        parallelCountingSortBy(order, n, degree, !ascending);
+
+        parallelFor(numVertex, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+            for (unsigned long long v=start; v<end; v++)
+                if (firstKey[v] == numEdges && firstOther[v] < numEdges)
+                    slot[firstOther[v]] = v;
+        });
+        n += parallelPack(numEdges, [&](unsigned long long j) { return firstKey[other[j]] == numEdges && firstOther[other[j]] == j; },
+                          [&](unsigned long long j) { return slot[j]; }, order + n);
+        delete[] slot;
+    }
+    else
+    {
+        // hubs have at least the average degree over the vertices that show up
+        V seen = parallelPack(numVertex, [&](unsigned long long v) { return firstKey[v] < numEdges || firstOther[v] < numEdges; },
+                              [&](unsigned long long v) { return (V) v; }, order);
+        double avg = (seen == 0) ? 0 : (double) numEdges / seen;
+        n = parallelPack(numVertex, [&](unsigned long long v) { return (firstKey[v] < numEdges || firstOther[v] < numEdges) && degree[v] >= avg; },
+                         [&](unsigned long long v) { return (V) v; }, order);
+        if (hubSort)
+            parallelCountingSortBy(order, n, degree, !ascending);
+        printf("average degree = %lf, hubs = %u\n", avg, n);
+        n += parallelPack(numVertex, [&](unsigned long long v) { return (firstKey[v] < numEdges || firstOther[v] < numEdges) && degree[v] < avg; },
+                          [&](unsigned long long v) { return (V) v; }, order + n);
+    }
+    // ids that never show up keep their relative order at the end
+    n += parallelPack(numVertex, [&](unsigned long long v) { return firstKey[v] == numEdges && firstOther[v] == numEdges; },
+                      [&](unsigned long long v) { return (V) v; }, order + n);
+
+    if (maintain && numVertex > 0)
+    {
+        V p = 0;
+        while (order[p] != 0)
+            p++;
+        memmove(order + 1, order, p * sizeof(V));
+        order[0] = 0;
+    }
+
+    delete[] degree;
+    delete[] firstKey;
+    delete[] firstOther;
+}
+
+template void degreeOrder (const unsigned int*, const unsigned int*, unsigned long long, unsigned int, bool, unsigned int*);
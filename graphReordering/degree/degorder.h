@@ -0,0 +1,15 @@
+#ifndef DEGORDER_HEADER_INCL
+#define DEGORDER_HEADER_INCL
+
+#include "graph.h"
+
+// deg's flags: lowest degree first, and with hub clustering the hubs sorted by degree
+extern bool ascending, hubSort;
+
+// deg's order of the edge list (src, dst) over the ids [0, numVertex), order[r] is
+// set to the vertex at rank r. degree sort, or hub clustering with hub, as described
+// in the README, with maintain vertex 0 is moved to the front
+template <typename V, typename E>
+void degreeOrder (const V* src, const V* dst, E numEdges, V numVertex, bool hub, V* order);
+
+#endif
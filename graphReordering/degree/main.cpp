@@ -0,0 +1,95 @@
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "parallel.h"
+#include "degorder.h"
+#ifndef GRAPH_HEADER_INCL
+#include "graph.h"
+#endif
+
+using namespace std;
+
+bool weighted = false, maintain = false, indegree = false;
+// lowest degree first instead of highest degree first
+bool ascending = false;
+// hub clustering (hubs first, both groups in id order) instead of degree sort,
+// with hubSort the hubs are also sorted by degree
+bool hubMode = false, hubSort = false;
+
+template <typename V, typename E>
+int reorder (char*, char*);
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("Usage : %s <--hub(optional)> <--sort(optional)> <--ascending(optional)> <--maintain(optional)> <--weighted(optional)> <--indegree(optional)> <--threads n(optional)> <inputFile1> <outputFile>\n", argv[0]);
+        exit(1);
+    }
+    for (int i = 1; i < argc-2; i++){
+      char * opt = argv[i];
+      if (strcmp(opt, "-m") == 0 || strcmp(opt,"--maintain") == 0) maintain = true;
+      else if (strcmp(opt, "-i") == 0 || strcmp(opt,"--indegree") == 0) indegree = true;
+      else if (strcmp(opt, "-w") == 0 || strcmp(opt,"--weighted") == 0) weighted = true;
+      else if (strcmp(opt, "-a") == 0 || strcmp(opt,"--ascending") == 0) ascending = true;
+      else if (strcmp(opt, "-s") == 0 || strcmp(opt,"--sort") == 0) hubSort = true;
+      else if (strcmp(opt, "--hub") == 0) hubMode = true;
+      else if ((strcmp(opt, "-t") == 0 || strcmp(opt,"--threads") == 0) && i+1 < argc-2) numThreads = atoi(argv[++i]);
+    }
+
+    // ids are not compacted, the edge count decides nothing here
+    return reorder<unsigned int, unsigned long long>(argv[argc-2], argv[argc-1]);
+}
+
+template <typename V, typename E>
+int reorder (char* inFile, char* outFile)
+{
+    V* src;
+    V* dst;
+    unsigned int* weights;
+    E numEdges;
+    V numVertex;
+
+    // edges are kept in file order, the output lists them in the same order
+    if (read_edge_list(inFile, src, dst, weights, numEdges, numVertex) < 0)
+        exit(1);
+
+    printf("file reading done. Num vertices = %d and numEdges = %llu\n", numVertex, (unsigned long long) numEdges);
+
+    struct timeval start, end;
+    gettimeofday(&start, NULL);
+
+    // order[r] is the vertex that gets rank r
+    V* order = new V [numVertex];
+    degreeOrder(src, dst, numEdges, numVertex, hubMode, order);
+
+    // newId gives the new position of a vertex
+    V* newId = new V [numVertex];
+    parallelFor(numVertex, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long r=start; r<end; r++)
+            newId[order[r]] = r;
+    });
+    gettimeofday(&end, NULL);
+
+    printf("%s, %lf \n", outFile, (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec)/1e6);
+
+    if (write_new_order("new_order.el", newId, numVertex) < 0)
+        exit(1);
+    if (is_serialized_graph(outFile))
+    {
+        if (write_relabeled_serialized_graph(outFile, src, dst, weights, numEdges, numVertex, (const V*) newId) < 0)
+            exit(1);
+    }
+    else if (write_relabeled_edge_list(outFile, src, dst, weights, numEdges, newId) < 0)
+        exit(1);
+
+    delete[] order;
+    delete[] newId;
+    delete[] src;
+    delete[] dst;
+    delete[] weights;
+
+    return 0;
+}
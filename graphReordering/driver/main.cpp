@@ -0,0 +1,304 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+#include "parallel.h"
+#include "countingsort.h"
+#ifndef GRAPH_HEADER_INCL
+#include "graph.h"
+#endif
+#include "../pH/phorder.h"
+#include "../block_reordering/brorder.h"
+#include "../../gorder/Gorder_code/Graph.h"
+
+using namespace std;
+
+bool weighted = false, maintain = false, indegree = false;
+
+// defaults as in the single tools
+unsigned int CACHE_SIZE = 100000;
+unsigned int CLSize = 20;
+// > 1 runs the partitioned pH and the parallel Gorder
+unsigned int numParts = 0;
+int gorderWindow = 5;
+// degree and hub options, as in deg
+bool ascending = false, hubSort = false;
+// orderings computed at the same time
+unsigned int numJobs = 1;
+// write gapbs .sg / .wsg files instead of edge lists
+bool serialized = false;
+
+const char* allAlgos = "ph,br,gorder,rcm,degree,hub";
+
+// everything the orderings share, built once
+template <typename V, typename E>
+struct sharedGraph
+{
+    // csr in the direction of --indegree and its reverse
+    graphT<V, E> G1, G2;
+    // gorder and rcm run on the out-csr relabeled by rcm
+    Gorder::Graph* gorder = NULL;
+    vector<int> rcm;
+};
+
+template <typename V, typename E>
+int run (char*, char*, vector<string>&);
+
+int main(int argc, char** argv)
+{
+    const char* algos = allAlgos;
+
+    if (argc < 3)
+    {
+        printf("Usage : %s <--algos ph,br,gorder,rcm,degree,hub(optional)> <--jobs n(optional)> <--cache n(optional)> <--line n(optional)> <--partitions n(optional)> <--window n(optional)> <--sort(optional)> <--ascending(optional)> <--maintain(optional)> <--weighted(optional)> <--indegree(optional)> <--threads n(optional)> <--serialized(optional)> <--verify(optional)> <inputFile1> <outputPrefix>\n", argv[0]);
+        exit(1);
+    }
+    for (int i = 1; i < argc-2; i++){
+      char * opt = argv[i];
+      if (strcmp(opt, "-m") == 0 || strcmp(opt,"--maintain") == 0) maintain = true;
+      else if (strcmp(opt, "-i") == 0 || strcmp(opt,"--indegree") == 0) indegree = true;
+      else if (strcmp(opt, "-w") == 0 || strcmp(opt,"--weighted") == 0) weighted = true;
+      else if (strcmp(opt, "-a") == 0 || strcmp(opt,"--ascending") == 0) ascending = true;
+      else if (strcmp(opt, "-s") == 0 || strcmp(opt,"--sort") == 0) hubSort = true;
+      else if (strcmp(opt,"--serialized") == 0) serialized = true;
+      else if (strcmp(opt, "--algos") == 0 && i+1 < argc-2) algos = argv[++i];
+      else if ((strcmp(opt, "-j") == 0 || strcmp(opt,"--jobs") == 0) && i+1 < argc-2) numJobs = atoi(argv[++i]);
+      else if ((strcmp(opt, "-c") == 0 || strcmp(opt,"--cache") == 0) && i+1 < argc-2) CACHE_SIZE = atoi(argv[++i]);
+      else if ((strcmp(opt, "-l") == 0 || strcmp(opt,"--line") == 0) && i+1 < argc-2) CLSize = atoi(argv[++i]);
+      else if ((strcmp(opt, "-p") == 0 || strcmp(opt,"--partitions") == 0) && i+1 < argc-2) numParts = atoi(argv[++i]);
+      else if ((strcmp(opt, "-W") == 0 || strcmp(opt,"--window") == 0) && i+1 < argc-2) gorderWindow = atoi(argv[++i]);
+      else if ((strcmp(opt, "-t") == 0 || strcmp(opt,"--threads") == 0) && i+1 < argc-2) numThreads = atoi(argv[++i]);
+      else if (strcmp(opt, "--verify") == 0) verifyChecksum = true;
+    }
+
+    vector<string> list;
+    string cur;
+    for (const char* p = algos; ; p++)
+    {
+        if (*p == ',' || *p == '\0')
+        {
+            if (cur != "ph" && cur != "br" && cur != "gorder" && cur != "rcm" && cur != "degree" && cur != "hub")
+            {
+                fprintf(stderr, "unknown ordering %s, expected one of %s\n", cur.c_str(), allAlgos);
+                exit(1);
+            }
+            list.push_back(cur);
+            cur.clear();
+            if (*p == '\0')
+                break;
+        }
+        else
+            cur += *p;
+    }
+
+    // 64-bit edge offsets only when the graph needs them
+    if (needs_wide_offsets(argv[argc-2]))
+        return run<unsigned int, unsigned long long>(argv[argc-2], argv[argc-1], list);
+    return run<unsigned int, unsigned int>(argv[argc-2], argv[argc-1], list);
+}
+
+// the orderings fill newId[v] with the new id of vertex v
+
+template <typename V, typename E>
+void phNewIds (sharedGraph<V, E>* S, V* newId)
+{
+    V* nodeId = new V [S->G1.numVertex];
+    V degThresh = sqrt(S->G1.numVertex);
+    if (numParts > 1)
+        phOrderPartitioned(&S->G1, &S->G2, degThresh, CACHE_SIZE, numParts, nodeId);
+    else
+        phOrder(&S->G1, &S->G2, degThresh, CACHE_SIZE, nodeId);
+    for (V i=0; i<S->G1.numVertex; i++)
+        newId[nodeId[i]] = i;
+    delete[] nodeId;
+}
+
+template <typename V, typename E>
+void brNewIds (sharedGraph<V, E>* S, V* newId)
+{
+    V* nodeId = new V [S->G1.numVertex];
+    brOrder(&S->G1, CLSize, CACHE_SIZE, nodeId);
+    for (V i=0; i<S->G1.numVertex; i++)
+        newId[nodeId[i]] = i;
+    delete[] nodeId;
+}
+
+template <typename V, typename E>
+void gorderNewIds (sharedGraph<V, E>* S, V* newId)
+{
+    vector<int> order;
+    if (numParts > 1)
+        S->gorder->GorderGreedyParallel(order, gorderWindow, numParts);
+    else
+        S->gorder->GorderGreedy(order, gorderWindow);
+    // the gorder graph is already relabeled by rcm
+    for (V v=0; v<S->G1.numVertex; v++)
+        newId[v] = order[S->rcm[v]];
+}
+
+template <typename V, typename E>
+void rcmNewIds (sharedGraph<V, E>* S, V* newId)
+{
+    for (V v=0; v<S->G1.numVertex; v++)
+        newId[v] = S->rcm[v];
+}
+
+// degree sort and hub sort / hub clustering on the degrees of G1. not deg's order:
+// the ids are compacted and ties are broken by id. with maintain vertex 0 is moved to the
+// front instead of swapped
+template <typename V, typename E>
+void degreeNewIds (sharedGraph<V, E>* S, V* newId, bool hub)
+{
+    graphT<V, E>* G = &S->G1;
+    V n = G->numVertex;
+    V* degree = new V [n];
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long v=start; v<end; v++)
+            degree[v] = G->VI[v+1] - G->VI[v];
+    });
+
+    V* order = new V [n];
+    V k;
+    if (!hub)
+    {
+        k = parallelPack(n, [&](unsigned long long v) { return degree[v] > 0; },
+                         [&](unsigned long long v) { return (V) v; }, order);
+        parallelCountingSortBy(order, k, degree, !ascending);
+        parallelPack(n, [&](unsigned long long v) { return degree[v] == 0; },
+                     [&](unsigned long long v) { return (V) v; }, order + k);
+    }
+    else
+    {
+        double avg = (n == 0) ? 0 : (double) G->numEdges / n;
+        k = parallelPack(n, [&](unsigned long long v) { return degree[v] >= avg; },
+                         [&](unsigned long long v) { return (V) v; }, order);
+        if (hubSort)
+            parallelCountingSortBy(order, k, degree, !ascending);
+        parallelPack(n, [&](unsigned long long v) { return degree[v] < avg; },
+                     [&](unsigned long long v) { return (V) v; }, order + k);
+    }
+
+    if (maintain)
+    {
+        V p = 0;
+        while (order[p] != 0)
+            p++;
+        memmove(order + 1, order, p * sizeof(V));
+        order[0] = 0;
+    }
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long r=start; r<end; r++)
+            newId[order[r]] = r;
+    });
+    delete[] degree;
+    delete[] order;
+}
+
+// computes one ordering and writes <prefix>_<algo>.el (.sg / .wsg with --serialized) and <prefix>_<algo>_order.el
+template <typename V, typename E>
+void runOrdering (sharedGraph<V, E>* S, const string& algo, const string& prefix)
+{
+    V n = S->G1.numVertex;
+    V* newId = new V [n];
+
+    struct timeval start, end;
+    gettimeofday(&start, NULL);
+    if (algo == "ph")
+        phNewIds(S, newId);
+    else if (algo == "br")
+        brNewIds(S, newId);
+    else if (algo == "gorder")
+        gorderNewIds(S, newId);
+    else if (algo == "rcm")
+        rcmNewIds(S, newId);
+    else
+        degreeNewIds(S, newId, algo == "hub");
+    gettimeofday(&end, NULL);
+
+    // same as ph and br: vertex 0 swaps ids with the vertex that got id 0
+    if (maintain && newId[0] != 0)
+    {
+        for (V i=1; i<n; i++)
+        {
+            if (newId[i] == 0)
+            {
+                newId[i] = newId[0];
+                break;
+            }
+        }
+        newId[0] = 0;
+    }
+
+    V* nodeId = new V [n];
+    for (V v=0; v<n; v++)
+        nodeId[newId[v]] = v;
+
+    string outFile = prefix + "_" + algo + (serialized ? (weighted ? ".wsg" : ".sg") : ".el");
+    string orderFile = prefix + "_" + algo + "_order.el";
+    if (serialized)
+    {
+        if (write_serialized_graph((char*) outFile.c_str(), &S->G1, &S->G2, nodeId, newId) < 0)
+            exit(1);
+    }
+    else
+    {
+        graphT<V, E> R;
+        permute_csr(&S->G1, nodeId, newId, &R);
+        write_edge_list((char*) outFile.c_str(), &R, newId);
+        freeMem(&R);
+    }
+    if (write_original_order(orderFile.c_str(), &S->G1, (const V*) newId) < 0)
+        exit(1);
+    printf("%s, %lf \n", outFile.c_str(), (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec)/1e6);
+    delete[] newId;
+    delete[] nodeId;
+}
+
+template <typename V, typename E>
+int run (char* inFile, char* prefix, vector<string>& algos)
+{
+    sharedGraph<V, E> S;
+
+    // read csr file, a .bcsr input also brings the reverse csr along
+    if (read_csr(inFile, &S.G1, &S.G2)==-1)
+        exit(1);
+
+    printf("file reading done. Num vertices = %d and numEdges = %llu\n", S.G1.numVertex, (unsigned long long) S.G1.numEdges);
+
+    if (S.G2.VI == NULL)
+        createReverseCSR(&S.G1, &S.G2, S.G1.numVertex);
+
+    bool needGorder = false;
+    for (size_t a=0; a<algos.size(); a++)
+        needGorder = needGorder || algos[a] == "gorder" || algos[a] == "rcm";
+    if (needGorder)
+    {
+        graphT<V, E>* out = indegree ? &S.G2 : &S.G1;
+        S.gorder = new Gorder::Graph();
+        S.gorder->readCSR(out->numVertex, out->VI, out->EI);
+        S.gorder->Transform(S.rcm);
+    }
+
+    // the threads are split between the orderings that run at the same time
+    unsigned int jobs = (numJobs == 0) ? 1 : numJobs;
+    if (jobs > algos.size())
+        jobs = algos.size();
+    unsigned int workers = (numThreads == 0) ? 1 : numThreads;
+    numThreads = (workers / jobs > 0) ? workers / jobs : 1;
+
+    string pre(prefix);
+    parallelFor(algos.size(), jobs, [&](unsigned int tid, unsigned long long first, unsigned long long last) {
+        for (unsigned long long a=first; a<last; a++)
+            runOrdering(&S, algos[a], pre);
+    });
+
+    delete S.gorder;
+    freeMem(&S.G1);
+    freeMem(&S.G2);
+
+    return 0;
+}
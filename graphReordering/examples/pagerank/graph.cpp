@@ -1,4 +1,5 @@
 #include "graph.h"
+#include "transpose.h"
 
 int read_csr (char* filename, graph* G)
 {
@@ -57,6 +58,17 @@ void initGraph (graph* G, int* deg )
     return;
 }
 
+void transposeGraph (graph* G)
+{
+    int* VI = new int [G->numVertex+1];
+    int* EI = new int [G->numEdges > 0 ? G->numEdges : 1];
+    parallelTranspose(G->numVertex, [&](int u) { return G->VI[u]; }, (const int*) G->EI, G->numVertex, VI, EI);
+    delete[] G->VI;
+    delete[] G->EI;
+    G->VI = VI;
+    G->EI = EI;
+}
+
 void freeMem (graph* G)
 {
     delete[] G->VI;
@@ -15,4 +15,8 @@ int read_csr (char*, graph*);
 
 void initGraph (graph*, int*);
 
+// replaces G by its transpose (parallel, see ../../transpose.h)
+// so an out-csr can be used for pull style pagerank
+void transposeGraph (graph*);
+
 void freeMem(graph*);
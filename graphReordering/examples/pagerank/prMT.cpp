@@ -1,11 +1,13 @@
 #include <iostream>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <pthread.h>
 #include <time.h>
 
 #include "graph.h"
 #include "sort.h"
+#include "parallel.h"
 
 using namespace std;
 
@@ -77,24 +79,29 @@ void *prIter (void* threadArg)
 
 int main(int argc, char** argv)
 {
-    if (argc != 3)
+    if (argc != 3 && !(argc == 4 && strcmp(argv[1], "--out") == 0))
     {
-        printf("Usage : %s <filename> <numThreads> \n", argv[0]);
+        printf("Usage : %s <--out(optional)> <filename> <numThreads> \n", argv[0]);
         exit(1);
     }
+    // --out: the file holds the out-csr (csr_gen -l, without -i), pull from its transpose
+    bool outCSR = (argc == 4);
     
     double dampingFactor = 0.85;
     int rc;
-    NUM_THREADS = atoi(argv[2]);
+    NUM_THREADS = atoi(argv[argc-1]);
+    numThreads = NUM_THREADS;
     // graph object
     graph G;
 
     // read csr file
-    if (read_csr(argv[1], &G)==-1)
+    if (read_csr(argv[argc-2], &G)==-1)
     {
-        printf("couldn't read %s\n", argv[1]);
+        printf("couldn't read %s\n", argv[argc-2]);
         exit(1);
     }
+    if (outCSR)
+        transposeGraph(&G);
 
 #ifdef DEBUG
     printf("%d %d\n", G.numVertex, G.numEdges);
@@ -162,7 +169,7 @@ int main(int argc, char** argv)
 
 	if( clock_gettime( CLOCK_REALTIME, &end) == -1 ) { perror("clock gettime");}		
 	time = (end.tv_sec - start.tv_sec)+ (int)(end.tv_nsec - start.tv_nsec)/1e9;
-    printf("%s, %lf\n", argv[1], time);
+    printf("%s, %lf\n", argv[argc-2], time);
 
 	mergeSortWOkey (G.attr, 0, G.numVertex-1);
     FILE* fdump = fopen("dumpPR.txt", "w");
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/time.h>
 #include <ctime>
 //#include <time.h>
@@ -21,11 +22,13 @@ double read_timer();
 
 int main(int argc, char** argv)
 {
-    if (argc != 2)
+    if (argc != 2 && !(argc == 3 && strcmp(argv[1], "--out") == 0))
     {
-        printf("Usage : %s <filename>\n", argv[0]);
+        printf("Usage : %s <--out(optional)> <filename>\n", argv[0]);
         exit(1);
     }
+    // --out: the file holds the out-csr (csr_gen -l, without -i), pull from its transpose
+    bool outCSR = (argc == 3);
     
     double dampingFactor = 0.85;
 
@@ -33,11 +36,13 @@ int main(int argc, char** argv)
     graph G;
 
     // read csr file
-    if (read_csr(argv[1], &G)==-1)
+    if (read_csr(argv[argc-1], &G)==-1)
     {
-        printf("couldn't read %s\n", argv[1]);
+        printf("couldn't read %s\n", argv[argc-1]);
         exit(1);
     }
+    if (outCSR)
+        transposeGraph(&G);
 
 #ifdef DEBUG
     printf("%d %d\n", G.numVertex, G.numEdges);
@@ -77,7 +82,7 @@ int main(int argc, char** argv)
     end = clock();
 //    if (clock_gettime(CLOCK_REALTIME, &stop) == -1){perror("clock gettime");}
 //    double time = (stop.tv_sec - start.tv_sec) + ((double)(stop.tv_nsec - start.tv_nsec))/1e9;
-    printf("%s, %lf\n", argv[1], (double)(end-start)/CLOCKS_PER_SEC);
+    printf("%s, %lf\n", argv[argc-1], (double)(end-start)/CLOCKS_PER_SEC);
 
 	
 
@@ -1,244 +1,927 @@
 #include "graph.h"
+#include "parallel.h"
+#include "transpose.h"
+#include "countingsort.h"
+#include <algorithm>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 using namespace std;
 
-void write_edge_list(char* filename, graph* G, unsigned int * nodeMap){
-    unsigned int * VI = G->VI;
-    unsigned int * EI = G->EI;
-    unordered_map<string, unsigned int> weights = G->weights;
-    unordered_map<unsigned int, unsigned int> filtered_to_original = G->filtered_to_original;
-    unsigned int* map_to_node = new unsigned int [G->numVertex];
-    for (unsigned int i=0; i<G->numVertex; i++)
-        map_to_node[nodeMap[i]] = i;
+bool verifyChecksum = false;
+
+template <typename V, typename E>
+void write_edge_list(char* filename, graphT<V, E>* G, V * nodeMap){
+    E * VI = G->VI;
+    V * EI = G->EI;
+    unsigned int * weights = G->weights;
 
     FILE *fp;
     fp = fopen(filename, "w");
-    for (unsigned int i = 0; i < G->numVertex-1; ++i){
-        for(unsigned int j = VI[i]; j < VI[i+1]; ++j){
-          unsigned int s, d, w;
+    if (fp == NULL)
+    {
+        fputs("file error", stderr);
+        return;
+    }
+    for (V i = 0; i < G->numVertex-1; ++i){
+        for(E j = VI[i]; j < VI[i+1]; ++j){
+          unsigned long long s, d;
           s = indegree ? EI[j]: i;
           d = indegree ? i: EI[j];
-          w = weights[get_map_key(map_to_node[s], map_to_node[d])];
-          cout << s << " " << d << " "<< w<< endl;
           if (weighted){
-            fprintf(fp, "%d %d %d\n", s, d, w);
-            // cout <<" weight: " <<  w << endl;
+            fprintf(fp, "%llu %llu %u\n", s, d, weights[j]);
           }else{
 
-            fprintf(fp, "%d %d\n", s, d);
+            fprintf(fp, "%llu %llu\n", s, d);
           }
         }
     }
-    for(unsigned int j = VI[G->numVertex-1];  j < G->numEdges; ++j){
-      unsigned int s, d, w;
+    for(E j = VI[G->numVertex-1];  j < G->numEdges; ++j){
+      unsigned long long s, d;
       s = indegree ? EI[j]: G->numVertex-1;
       d = indegree ? G->numVertex-1: EI[j];
-      w = weights[get_map_key(map_to_node[s], map_to_node[d])];
-      // cout <<" weight: " <<  w << endl;
-      if (weighted) fprintf(fp, "%d %d %d\n", s, d, w);
-      else fprintf(fp, "%d %d\n", s, d);
+      if (weighted) fprintf(fp, "%llu %llu %u\n", s, d, weights[j]);
+      else fprintf(fp, "%llu %llu\n", s, d);
     }
     fclose(fp);
 }
 
-int read_edge_list (char* filename, std::vector<unsigned int>& src, std::vector<unsigned int>& dst,std::vector<unsigned int> &weights)
+template <typename V, typename E>
+int write_permuted_edge_list (char* filename, graphT<V, E>* G, V* nodeId, V* nodeMap)
 {
-    unsigned int numEdgesRead = 0;
-
-    FILE* fp = fopen (filename, "r");
+    FILE* fp = fopen(filename, "w");
     if (fp == NULL)
     {
         fputs("file error", stderr);
         return -1;
     }
+    for (V i = 0; i < G->numVertex; ++i){
+        V u = nodeId[i];
+        for (E j = G->VI[u]; j < G->VI[u+1]; ++j){
+          unsigned long long s, d;
+          s = indegree ? nodeMap[G->EI[j]] : i;
+          d = indegree ? i : nodeMap[G->EI[j]];
+          if (weighted) fprintf(fp, "%llu %llu %u\n", s, d, G->weights[j]);
+          else fprintf(fp, "%llu %llu\n", s, d);
+        }
+    }
+    fclose(fp);
+    return 1;
+}
 
-    unsigned int srcVal = 0;
-    unsigned int dstVal = 0;
-    unsigned int w;
-    int numVertex = 0;
+bool is_serialized_graph (const char* filename)
+{
+    size_t len = strlen(filename);
+    return (len >= 3 && strcmp(filename + len - 3, ".sg") == 0) ||
+           (len >= 4 && strcmp(filename + len - 4, ".wsg") == 0);
+}
+
+static inline unsigned int sgVertex (unsigned int v) { return v; }
+static inline unsigned int sgVertex (const pair<unsigned int, unsigned int>& e) { return e.first; }
+
+// rows [0, n) of G relabeled: row i is row nodeId[i] of G with every entry made by
+// entry(j) (neighbor mapped through nodeMap, weight). every row is sorted, duplicate
+// neighbors (the lowest weight stays) and self loops are dropped as in gapbs' SquishCSR.
+// offsets gets the n+1 offsets, returns the packed rows
+template <typename T, typename V, typename E, typename F>
+static T* squish_rows (graphT<V, E>* G, V* nodeId, V n, F entry, long long* offsets)
+{
+    E* deg = new E [n];
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long i=start; i<end; i++)
+            deg[i] = G->VI[nodeId[i]+1] - G->VI[nodeId[i]];
+    });
+    E* rowStart = new E [n+1];
+    parallelPrefixSum(deg, rowStart, n);
+    T* rows = new T [rowStart[n] > 0 ? rowStart[n] : 1];
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long i=start; i<end; i++)
+        {
+            T* b = rows + rowStart[i];
+            T* e = b + deg[i];
+            E from = G->VI[nodeId[i]];
+            for (E k=0; k<deg[i]; k++)
+                b[k] = entry(from + k);
+            sort(b, e);
+            e = unique(b, e, [](const T& x, const T& y) { return sgVertex(x) == sgVertex(y); });
+            e = remove_if(b, e, [&](const T& x) { return sgVertex(x) == i; });
+            deg[i] = e - b;
+        }
+    });
+    parallelPrefixSum(deg, offsets, n);
+    T* packed = new T [offsets[n] > 0 ? offsets[n] : 1];
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long i=start; i<end; i++)
+            memcpy(packed + offsets[i], rows + rowStart[i], deg[i] * sizeof(T));
+    });
+    delete[] deg;
+    delete[] rowStart;
+    delete[] rows;
+    return packed;
+}
+
+template <typename T, typename V, typename E, typename F>
+static bool write_sg_csr (FILE* fp, graphT<V, E>* G, V* nodeId, V n, F entry, bool header)
+{
+    long long* offsets = new long long [n+1];
+    T* neighs = squish_rows<T>(G, nodeId, n, entry, offsets);
+    long long numEdges = offsets[n];
+    long long numNodes = n;
+    bool directed = true;
+    bool ok = true;
+    if (header)
+        ok = fwrite(&directed, sizeof(bool), 1, fp) == 1 &&
+             fwrite(&numEdges, sizeof(long long), 1, fp) == 1 &&
+             fwrite(&numNodes, sizeof(long long), 1, fp) == 1;
+    ok = ok && fwrite(offsets, sizeof(long long), n+1, fp) == (size_t) n+1 &&
+         fwrite(neighs, sizeof(T), numEdges, fp) == (size_t) numEdges;
+    delete[] offsets;
+    delete[] neighs;
+    return ok;
+}
 
-    while(!feof(fp))
+template <typename V, typename E>
+int write_serialized_graph (char* filename, graphT<V, E>* G, graphT<V, E>* rev, V* nodeId, V* nodeMap)
+{
+    graphT<V, E>* out = indegree ? rev : G;
+    graphT<V, E>* in = indegree ? G : rev;
+    size_t len = strlen(filename);
+    bool wsg = len >= 4 && strcmp(filename + len - 4, ".wsg") == 0;
+    if (wsg != (G->weights != NULL))
     {
-        if(fscanf(fp, "%d", &srcVal) <= 0)
-            break;
-        fscanf(fp, "%d", &dstVal);
-        if (weighted) fscanf(fp, "%d", &w);
-        numVertex = (srcVal > numVertex) ? srcVal : numVertex;
-        numVertex = (dstVal > numVertex) ? dstVal : numVertex;
-        if (srcVal != dstVal)
+        fputs(wsg ? ".wsg needs a weighted graph (-w)\n" : ".sg is for unweighted graphs, use .wsg\n", stderr);
+        return -1;
+    }
+
+    // gapbs takes one past the largest id that shows up in an edge as the vertex count
+    unsigned int T = (numThreads == 0) ? 1 : numThreads;
+    V* localMax = new V [T]();
+    unsigned char* any = new unsigned char [T]();
+    parallelFor(G->numVertex, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long v=start; v<end; v++)
         {
-            src.push_back(srcVal);
-            dst.push_back(dstVal);
-            if (weighted) weights.push_back(w);
-            numEdgesRead++;
+            if (G->VI[v+1] == G->VI[v] && rev->VI[v+1] == rev->VI[v])
+                continue;
+            any[tid] = 1;
+            if (nodeMap[v] >= localMax[tid])
+                localMax[tid] = nodeMap[v];
         }
+    });
+    V n = 0;
+    for (unsigned int t=0; t<T; t++)
+        if (any[t] && localMax[t] + 1 > n)
+            n = localMax[t] + 1;
+    delete[] localMax;
+    delete[] any;
+
+    FILE* fp = fopen(filename, "wb");
+    if (fp == NULL)
+    {
+        fputs("file error", stderr);
+        return -1;
+    }
+    bool ok;
+    if (wsg)
+    {
+        typedef pair<unsigned int, unsigned int> nodeWeight;
+        ok = write_sg_csr<nodeWeight>(fp, out, nodeId, n, [&](E j) { return nodeWeight(nodeMap[out->EI[j]], out->weights[j]); }, true) &&
+             write_sg_csr<nodeWeight>(fp, in, nodeId, n, [&](E j) { return nodeWeight(nodeMap[in->EI[j]], in->weights[j]); }, false);
     }
+    else
+        ok = write_sg_csr<unsigned int>(fp, out, nodeId, n, [&](E j) { return nodeMap[out->EI[j]]; }, true) &&
+             write_sg_csr<unsigned int>(fp, in, nodeId, n, [&](E j) { return nodeMap[in->EI[j]]; }, false);
+    if (fclose(fp) != 0 || !ok)
+    {
+        fputs("file error", stderr);
+        return -1;
+    }
+    return 1;
+}
 
-    fclose(fp);
+// relabels the edges into a csr and writes it like write_serialized_graph, for the
+// tools that keep the edge list (newId does not have to be a permutation)
+template <typename V, typename E>
+int write_relabeled_serialized_graph (char* filename, V* src, V* dst, unsigned int* weights, E numEdges, V numVertex, const V* newId)
+{
+    V n = 0;
+    for (V v=0; v<numVertex; v++)
+        if (newId[v] + 1 > n)
+            n = newId[v] + 1;
+    V* s = new V [numEdges > 0 ? numEdges : 1];
+    V* d = new V [numEdges > 0 ? numEdges : 1];
+    parallelFor(numEdges, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long j=start; j<end; j++)
+        {
+            s[j] = newId[src[j]];
+            d[j] = newId[dst[j]];
+        }
+    });
+    graphT<V, E> G, R;
+    build_csr(s, d, weights, numEdges, n, &G);
+    delete[] s;
+    delete[] d;
+    createReverseCSR(&G, &R, n);
+    V* identity = new V [n];
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long v=start; v<end; v++)
+            identity[v] = v;
+    });
+    int ret = write_serialized_graph(filename, &G, &R, identity, identity);
+    delete[] identity;
+    freeMem(&G);
+    freeMem(&R);
+    return ret;
+}
 
-    return ++numVertex;
+// hand-rolled scanner helpers for the mmap'd edge list
+// a line is "<src> <dst> [weight]" separated by spaces or tabs,
+// lines that don't start with a digit (comments, headers, blanks) are skipped
+static inline const char* skipBlanks (const char* p, const char* end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        p++;
+    return p;
 }
 
-unsigned int filter (std::vector<unsigned int>& src, std::vector<unsigned int>& dst, std::vector<unsigned int> & weights, graph * G, unsigned int numVertex, unsigned int numEdgesRead)
+static inline const char* nextLine (const char* p, const char* end)
 {
-    bool* exists = new bool [numVertex]();
-    for (unsigned int i=0; i<numEdgesRead; i++)
+    const char* nl = (const char*) memchr(p, '\n', end - p);
+    return (nl == NULL) ? end : nl + 1;
+}
+
+template <typename T>
+static inline const char* scanUint (const char* p, const char* end, T& val, bool& ok)
+{
+    T v = 0;
+    const char* begin = p;
+    while (p < end && (unsigned char)(*p - '0') < 10)
+        v = v*10 + (*p++ - '0');
+    ok = (p != begin);
+    val = v;
+    return p;
+}
+
+template <typename V>
+struct chunkEdges
+{
+    vector<V> src;
+    vector<V> dst;
+    vector<unsigned int> weights;
+    V maxId;
+};
+
+template <typename V>
+static void parse_chunk (const char* p, const char* chunkEnd, const char* fileEnd, chunkEdges<V>* C)
+{
+    C->maxId = 0;
+    while (p < chunkEnd)
     {
-        exists[src[i]]=true;
-        exists[dst[i]]=true;
-        if (weighted) cout << src[i] << " " << dst[i] << " " << weights[i] << endl;
+        const char* lineStart = p;
+        V s, d;
+        unsigned int w = 0;
+        bool ok;
+        p = skipBlanks(p, fileEnd);
+        p = scanUint(p, fileEnd, s, ok);
+        if (ok)
+        {
+            p = skipBlanks(p, fileEnd);
+            p = scanUint(p, fileEnd, d, ok);
+        }
+        if (ok)
+        {
+            if (weighted)
+            {
+                bool wok;
+                p = skipBlanks(p, fileEnd);
+                p = scanUint(p, fileEnd, w, wok);
+            }
+            C->src.push_back(s);
+            C->dst.push_back(d);
+            if (weighted) C->weights.push_back(w);
+            C->maxId = (s > C->maxId) ? s : C->maxId;
+            C->maxId = (d > C->maxId) ? d : C->maxId;
+        }
+        p = nextLine((p > lineStart) ? p : lineStart, fileEnd);
     }
+}
 
-    unsigned int* vertexMap = new unsigned int [numVertex]();
-    unsigned int actualVertices = 0;
-    for (unsigned int i=0; i<numVertex; i++)
+// mmaps the edge list, splits it into line aligned chunks and parses
+// every chunk on its own thread, the chunks are then stitched back in file order
+template <typename V, typename E>
+int read_edge_list (char* filename, V*& src, V*& dst, unsigned int*& weights, E& numEdgesRead, V& numVertex)
+{
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
     {
-        if (exists[i]){
-            vertexMap[i] = actualVertices++;
-            G->filtered_to_original[actualVertices-1] = i;
+        fputs("file error", stderr);
+        return -1;
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) < 0)
+    {
+        fputs("file error", stderr);
+        close(fd);
+        return -1;
+    }
+    size_t size = sb.st_size;
+    const char* buf = NULL;
+    if (size > 0)
+    {
+        buf = (const char*) mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (buf == MAP_FAILED)
+        {
+            fputs("mmap error", stderr);
+            close(fd);
+            return -1;
         }
+        madvise((void*) buf, size, MADV_SEQUENTIAL);
     }
+    const char* fileEnd = buf + size;
 
-    for (unsigned int i=0; i<numEdgesRead; i++)
+    unsigned int numChunks = (numThreads == 0) ? 1 : numThreads;
+    size_t* chunkStart = new size_t [numChunks+1];
+    for (unsigned int c=0; c<numChunks; c++)
     {
-        src[i] = vertexMap[src[i]];
-        dst[i] = vertexMap[dst[i]];
-        if (weighted) G->weights[get_map_key(src[i], dst[i])] = weights[i];
+        size_t pos = (size * c) / numChunks;
+        if (pos > 0 && buf[pos-1] != '\n')
+            pos = nextLine(buf + pos, fileEnd) - buf;
+        chunkStart[c] = pos;
     }
+    chunkStart[numChunks] = size;
 
-    delete[] exists;
-    delete[] vertexMap;
+    chunkEdges<V>* chunks = new chunkEdges<V> [numChunks];
+    parallelFor(numChunks, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long c=start; c<end; c++)
+        {
+            size_t b = chunkStart[c];
+            size_t e = (chunkStart[c+1] > b) ? chunkStart[c+1] : b;
+            parse_chunk(buf + b, buf + e, fileEnd, &chunks[c]);
+        }
+    });
 
-    return actualVertices;
+    size_t* edgeOffset = new size_t [numChunks+1];
+    edgeOffset[0] = 0;
+    numVertex = 0;
+    for (unsigned int c=0; c<numChunks; c++)
+    {
+        edgeOffset[c+1] = edgeOffset[c] + chunks[c].src.size();
+        if (chunks[c].src.size() > 0 && chunks[c].maxId + 1 > numVertex)
+            numVertex = chunks[c].maxId + 1;
+    }
+    numEdgesRead = edgeOffset[numChunks];
+    if (numEdgesRead != edgeOffset[numChunks])
+    {
+        fputs("edge list has too many edges for 32-bit offsets\n", stderr);
+        delete[] chunks;
+        delete[] edgeOffset;
+        delete[] chunkStart;
+        munmap((void*) buf, size);
+        close(fd);
+        return -1;
+    }
+
+    src = new V [numEdgesRead];
+    dst = new V [numEdgesRead];
+    weights = weighted ? new unsigned int [numEdgesRead] : NULL;
+    parallelFor(numChunks, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long c=start; c<end; c++)
+        {
+            size_t n = chunks[c].src.size();
+            if (n == 0)
+                continue;
+            memcpy(src + edgeOffset[c], chunks[c].src.data(), n*sizeof(V));
+            memcpy(dst + edgeOffset[c], chunks[c].dst.data(), n*sizeof(V));
+            if (weighted)
+                memcpy(weights + edgeOffset[c], chunks[c].weights.data(), n*sizeof(unsigned int));
+            vector<V>().swap(chunks[c].src);
+            vector<V>().swap(chunks[c].dst);
+            vector<unsigned int>().swap(chunks[c].weights);
+        }
+    });
+
+    delete[] chunks;
+    delete[] edgeOffset;
+    delete[] chunkStart;
+    if (size > 0)
+        munmap((void*) buf, size);
+    close(fd);
+
+    return 1;
 }
 
-void csr_convert(std::vector<unsigned int>& src, std::vector<unsigned int>& dst, graph* G)
+#define WRITE_BLOCK (1ULL << 22)
+
+static inline char* formatUint (char* p, unsigned long long v)
 {
-    G->VI = new unsigned int [G->numVertex+1]();
-    G->EI = new unsigned int [G->numEdges]();
+    char tmp[24];
+    int n = 0;
+    do {
+        tmp[n++] = '0' + v % 10;
+        v /= 10;
+    } while (v != 0);
+    while (n > 0)
+        *p++ = tmp[--n];
+    return p;
+}
 
-    unsigned int* deg = new unsigned int [G->numVertex]();
-    for (unsigned int i=0; i<G->numEdges; i++){
-      if (indegree) deg[dst[i]]++;
-      else deg[src[i]]++;
+// edges are formatted in blocks, every thread fills its own buffer
+// and the buffers are written out in edge order
+template <typename V, typename E>
+int write_relabeled_edge_list (char* filename, V* src, V* dst, unsigned int* weights, E numEdges, const V* newId)
+{
+    FILE* fp = fopen(filename, "w");
+    if (fp == NULL)
+    {
+        fputs("file error", stderr);
+        return -1;
+    }
+    unsigned int T = (numThreads == 0) ? 1 : numThreads;
+    // three numbers of at most 20 digits plus separators per line
+    const size_t lineBytes = 64;
+    vector<char*> buf(T);
+    vector<size_t> len(T);
+    for (unsigned int t=0; t<T; t++)
+        buf[t] = new char [(WRITE_BLOCK / T + 1) * lineBytes];
+
+    for (unsigned long long b=0; b<(unsigned long long) numEdges; b+=WRITE_BLOCK)
+    {
+        unsigned long long n = min((unsigned long long) numEdges - b, WRITE_BLOCK);
+        unsigned int used = (n < T) ? (unsigned int) n : T;
+        parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+            char* p = buf[tid];
+            for (unsigned long long i=b+start; i<b+end; i++)
+            {
+                p = formatUint(p, newId[src[i]]);
+                *p++ = ' ';
+                p = formatUint(p, newId[dst[i]]);
+                if (weights != NULL)
+                {
+                    *p++ = ' ';
+                    p = formatUint(p, weights[i]);
+                }
+                *p++ = '\n';
+            }
+            len[tid] = p - buf[tid];
+        });
+        for (unsigned int t=0; t<used; t++)
+            fwrite(buf[t], 1, len[t], fp);
     }
 
+    for (unsigned int t=0; t<T; t++)
+        delete[] buf[t];
+    if (ferror(fp))
+    {
+        fputs("write error", stderr);
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+    return 1;
+}
 
-    for (unsigned int i=1; i<G->numVertex+1; i++)
-        G->VI[i] = G->VI[i-1] + deg[i-1];
+// one line per vertex, line i holds the new id of vertex i
+template <typename V>
+int write_new_order (const char* filename, const V* newId, V numVertex)
+{
+    FILE* fp = fopen(filename, "w");
+    if (fp == NULL)
+    {
+        fputs("file error", stderr);
+        return -1;
+    }
+    for (V v=0; v<numVertex; v++)
+        fprintf(fp, "%llu\n", (unsigned long long) newId[v]);
+    fclose(fp);
+    return 1;
+}
 
-    for (unsigned int i=0; i<G->numVertex; i++)
-        deg[i] = 0;
+// new_order.el of a csr read by read_csr: line o holds the new id of the input
+// vertex o, not of the compacted id, so it reads the same in relabel, metrics,
+// cachesim and spmplan. The ids without edges that filter dropped take the ids
+// past numVertex, in the order of their input id
+template <typename V, typename E>
+int write_original_order (const char* filename, graphT<V, E>* G, const V* newId)
+{
+    V n = G->numVertex;
+    if (G->filtered_to_original.size() != n)
+        return write_new_order(filename, newId, n);
+    V N = (n == 0) ? 0 : G->filtered_to_original[n-1] + 1;
+    V* origNewId = new V [N];
+    unsigned char* used = new unsigned char [N]();
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long v=start; v<end; v++)
+        {
+            origNewId[G->filtered_to_original[v]] = newId[v];
+            used[G->filtered_to_original[v]] = 1;
+        }
+    });
+    V tail = n;
+    for (V o=0; o<N; o++)
+        if (!used[o])
+            origNewId[o] = tail++;
+    int ret = write_new_order(filename, (const V*) origNewId, N);
+    delete[] origNewId;
+    delete[] used;
+    return ret;
+}
 
-    for (unsigned int i=0; i<G->numEdges; i++)
+// reads an order in the same format, any non digit separates the ids,
+// "-" reads it from stdin so a reorderer can be piped in
+template <typename V>
+int read_new_order (const char* filename, vector<V>& order)
+{
+    FILE* fp = (strcmp(filename, "-") == 0) ? stdin : fopen(filename, "r");
+    if (fp == NULL)
+    {
+        fputs("file error", stderr);
+        return -1;
+    }
+    const size_t blockSize = 1 << 20;
+    char* buf = new char [blockSize];
+    unsigned long long val = 0;
+    bool inNumber = false;
+    size_t n;
+    while ((n = fread(buf, 1, blockSize, fp)) > 0)
     {
-        if (indegree){
-          G->EI[G->VI[dst[i]] + deg[dst[i]]] = src[i];
-          deg[dst[i]]++;
-        } else {
-          G->EI[G->VI[src[i]] + deg[src[i]]] = dst[i];
-          deg[src[i]]++;
+        for (size_t i=0; i<n; i++)
+        {
+            if (buf[i] >= '0' && buf[i] <= '9')
+            {
+                val = val * 10 + (buf[i] - '0');
+                inNumber = true;
+            }
+            else if (inNumber)
+            {
+                order.push_back(val);
+                val = 0;
+                inNumber = false;
+            }
         }
     }
+    if (inNumber)
+        order.push_back(val);
+    delete[] buf;
+    if (fp != stdin)
+        fclose(fp);
+    return 1;
+}
 
+template <typename V, typename E>
+static V filter (V* src, V* dst, graphT<V, E> * G, V numVertex, E numEdgesRead)
+{
+    unsigned char* exists = new unsigned char [numVertex];
+    parallelFor(numVertex, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        memset(exists + start, 0, end - start);
+    });
+    parallelFor(numEdgesRead, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long i=start; i<end; i++)
+        {
+            __atomic_store_n(&exists[src[i]], 1, __ATOMIC_RELAXED);
+            __atomic_store_n(&exists[dst[i]], 1, __ATOMIC_RELAXED);
+        }
+    });
+
+    // compacted id of a vertex is the number of existing vertices before it
+    V* vertexMap = new V [numVertex+1];
+    parallelPrefixSum(exists, vertexMap, numVertex);
+    V actualVertices = vertexMap[numVertex];
+
+    G->filtered_to_original.resize(actualVertices);
+    parallelFor(numVertex, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long i=start; i<end; i++)
+        {
+            if (exists[i])
+                G->filtered_to_original[vertexMap[i]] = i;
+        }
+    });
+
+    parallelFor(numEdgesRead, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long i=start; i<end; i++)
+        {
+            src[i] = vertexMap[src[i]];
+            dst[i] = vertexMap[dst[i]];
+        }
+    });
+
+    delete[] exists;
+    delete[] vertexMap;
+
+    return actualVertices;
+}
+
+// builds the CSR with a parallel degree count, a prefix sum and a stable scatter,
+// every neighbor list keeps the order its edges had in the input (as the old serial
+// csr_convert did) whatever the thread count, weights move with their edge
+template <typename V, typename E>
+static void csr_rows(V* key, V* val, unsigned int* weights, graphT<V, E>* G)
+{
+    G->VI = new E [G->numVertex+1];
+    G->EI = new V [G->numEdges];
+    G->weights = (weights != NULL) ? new unsigned int [G->numEdges] : NULL;
+
+    E* deg = new E [G->numVertex];
+    parallelFor(G->numVertex, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        memset(deg + start, 0, (end - start)*sizeof(E));
+    });
+    parallelFor(G->numEdges, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long i=start; i<end; i++)
+            __atomic_fetch_add(&deg[key[i]], 1, __ATOMIC_RELAXED);
+    });
+
+    parallelPrefixSum(deg, G->VI, G->numVertex);
     delete[] deg;
+
+    if (G->numVertex == 0)
+        return;
+    parallelCountingSort(key, (V) (G->numVertex-1), val, G->EI, G->numEdges);
+    if (weights != NULL)
+        parallelCountingSort(key, (V) (G->numVertex-1), weights, G->weights, G->numEdges);
+}
+
+// the out-csr in input order, with --indegree the in-csr as the transpose of that
+// out-csr (the rows sorted by source), which is the in-csr a .bcsr file holds
+template <typename V, typename E>
+static void csr_convert(V* src, V* dst, unsigned int* weights, graphT<V, E>* G)
+{
+    if (!indegree)
+    {
+        csr_rows(src, dst, weights, G);
+        return;
+    }
+    graphT<V, E> out;
+    out.numVertex = G->numVertex;
+    out.numEdges = G->numEdges;
+    csr_rows(src, dst, weights, &out);
+    out.filtered_to_original.swap(G->filtered_to_original);
+    createReverseCSR(&out, G, G->numVertex);
+    freeMem(&out);
 }
 
-string get_map_key(unsigned int src, unsigned int dst) {
-  string key = "";
-  key += to_string(src);
-  key += ">";
-  key += to_string(dst);
-  return key;
+template <typename V, typename E>
+void build_csr (V* src, V* dst, unsigned int* weights, E numEdges, V numVertex, graphT<V, E>* G)
+{
+    G->numVertex = numVertex;
+    G->numEdges = numEdges;
+    G->filtered_to_original.clear();
+    G->file = NULL;
+    csr_convert(src, dst, weights, G);
 }
 
-int read_csr (char* filename, graph* G)
+// points G (and rev) at the sections of a mapped .bcsr file, with --indegree
+// the in-csr of the file becomes G and rev is left to the caller
+template <typename V, typename E>
+static int read_bcsr (char* filename, graphT<V, E>* G, graphT<V, E>* rev)
 {
-    std::vector<unsigned int> src;
-    std::vector<unsigned int> dst;
-    std::vector<unsigned int> weights;
+    bcsrFile* F = new bcsrFile;
+    if (open_bcsr(filename, F, verifyChecksum) < 0)
+    {
+        delete F;
+        return -1;
+    }
+    bcsrHeader* H = &F->header;
+    const char* err = NULL;
+    if (H->offsetBytes != sizeof(E) || H->idBytes != sizeof(V))
+        err = "bcsr: offset or id width of this file doesn't match the graph struct\n";
+    else if (weighted && !(H->flags & BCSR_WEIGHTS))
+        err = "bcsr: --weighted given but the file carries no weights\n";
+    else if (indegree && !(H->flags & BCSR_IN_CSR))
+        err = "bcsr: --indegree needs a file with the in-csr\n";
+    if (err != NULL)
+    {
+        fputs(err, stderr);
+        close_bcsr(F);
+        delete F;
+        return -1;
+    }
+
+    unsigned int fwd = indegree ? BCSR_IN_VI : BCSR_OUT_VI;
+    unsigned int bwd = indegree ? BCSR_OUT_VI : BCSR_IN_VI;
+    G->numVertex = H->numVertex;
+    G->numEdges = H->numEdges;
+    G->VI = (E*) F->section[fwd];
+    G->EI = (V*) F->section[fwd+1];
+    G->file = F;
+
+    G->filtered_to_original.resize(G->numVertex);
+    V* origId = (V*) F->section[BCSR_ORIG_ID];
+    parallelFor(G->numVertex, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long i=start; i<end; i++)
+            G->filtered_to_original[i] = (origId != NULL) ? origId[i] : i;
+    });
+
+    if (weighted)
+        G->weights = (unsigned int*) F->section[fwd+2];
+
+    // the out-csr of the file keeps the input order while the reverse the text
+    // path builds with --indegree is sorted, so with -i the caller builds rev
+    if (rev != NULL && (H->flags & BCSR_IN_CSR) && !indegree)
+    {
+        rev->numVertex = G->numVertex;
+        rev->numEdges = G->numEdges;
+        rev->VI = (E*) F->section[bwd];
+        rev->EI = (V*) F->section[bwd+1];
+        rev->file = F;
+        rev->filtered_to_original = G->filtered_to_original;
+        rev->weights = weighted ? (unsigned int*) F->section[bwd+2] : NULL;
+        F->refs++;
+    }
+    return 1;
+}
 
-    int numVertex = read_edge_list (filename, src, dst, weights);
-    if (numVertex < 0)
+bool needs_wide_offsets (const char* filename)
+{
+    if (is_bcsr(filename))
+    {
+        bcsrHeader H;
+        FILE* fp = fopen(filename, "rb");
+        bool wide = (fread(&H, sizeof(bcsrHeader), 1, fp) == 1) && (H.offsetBytes == sizeof(unsigned long long));
+        fclose(fp);
+        return wide;
+    }
+    // the shortest edge line is "0 1\n"
+    struct stat sb;
+    if (stat(filename, &sb) < 0)
+        return false;
+    return (unsigned long long) sb.st_size / 4 > 0xffffffffULL;
+}
+
+template <typename V, typename E>
+int read_csr (char* filename, graphT<V, E>* G, graphT<V, E>* rev)
+{
+    if (is_bcsr(filename))
+        return read_bcsr(filename, G, rev);
+
+    V* src;
+    V* dst;
+    unsigned int* weights;
+    E numEdgesRead;
+    V numVertex;
+
+    if (read_edge_list (filename, src, dst, weights, numEdgesRead, numVertex) < 0)
         return -1;
 
-    G->numEdges = src.size();
+    G->numEdges = numEdgesRead;
 
-    G->numVertex = filter(src, dst, weights, G, (unsigned int)numVertex, G->numEdges);
+    G->numVertex = filter(src, dst, G, numVertex, G->numEdges);
 
 
-    csr_convert(src, dst, G);
+    csr_convert(src, dst, weights, G);
 
+    delete[] src;
+    delete[] dst;
+    delete[] weights;
 
     return 1;
 }
-void printGraph (graph* G)
+
+template <typename V, typename E>
+void printGraph (graphT<V, E>* G)
 {
-    printf("number of vertices are %d\n", G->numVertex);
-    printf("number of edges are %d\n", G->numEdges);
-    for (unsigned int i=0; i<G->numVertex; i++)
-        printf("%d ", G->VI[i]);
+    printf("number of vertices are %llu\n", (unsigned long long) G->numVertex);
+    printf("number of edges are %llu\n", (unsigned long long) G->numEdges);
+    for (V i=0; i<G->numVertex; i++)
+        printf("%llu ", (unsigned long long) G->VI[i]);
     printf("\n");
-    for (unsigned int i=0; i<G->numEdges; i++)
-        printf("%d ", G->EI[i]);
+    for (E i=0; i<G->numEdges; i++)
+        printf("%llu ", (unsigned long long) G->EI[i]);
     printf("\n");
 }
 
 
-void write_csr (char* filename, graph* G)
+template <typename V, typename E>
+int write_csr (char* filename, graphT<V, E>* G)
 {
+    if (sizeof(E) != sizeof(unsigned int) || sizeof(V) != sizeof(unsigned int))
+    {
+        fputs("legacy csr can't hold 64-bit offsets, write a .bcsr instead\n", stderr);
+        return -1;
+    }
     FILE* fp = fopen(filename, "wb");
     if (fp == NULL)
     {
         fputs("file error", stderr);
-        return;
+        return -1;
     }
     fwrite(&G->numVertex, sizeof(unsigned int), 1, fp);
     fwrite(&G->numEdges, sizeof(unsigned int), 1, fp);
     fwrite(G->VI, sizeof(unsigned int), G->numVertex, fp);
     fwrite(G->EI, sizeof(unsigned int), G->numEdges, fp);
     fclose(fp);
+    return 1;
+}
+
+template <typename V, typename E>
+int write_bcsr (char* filename, graphT<V, E>* G, graphT<V, E>* rev)
+{
+    const void* sections[BCSR_NUM_SECTIONS] = {NULL};
+    sections[BCSR_OUT_VI] = G->VI;
+    sections[BCSR_OUT_EI] = G->EI;
+    sections[BCSR_IN_VI] = rev->VI;
+    sections[BCSR_IN_EI] = rev->EI;
+    if (G->filtered_to_original.size() == G->numVertex)
+        sections[BCSR_ORIG_ID] = G->filtered_to_original.data();
+    if (weighted)
+    {
+        sections[BCSR_OUT_W] = G->weights;
+        sections[BCSR_IN_W] = rev->weights;
+    }
+    return write_bcsr_file(filename, G->numVertex, G->numEdges, sizeof(E), sections);
 }
 
-void createReverseCSR(graph* G1, graph* G2, unsigned int G2numVertex)
+// the lists of G2 come out sorted, G1->VI only needs numVertex entries
+// (the last row ends at numEdges)
+template <typename V, typename E>
+void createReverseCSR(graphT<V, E>* G1, graphT<V, E>* G2, V G2numVertex)
 {
     G2->numVertex = G2numVertex;
     G2->numEdges = G1->numEdges;
-    G2->weights = G1->weights;
     G2->filtered_to_original = G1->filtered_to_original;
+    G2->file = NULL;
 
-    G2->VI = new unsigned int[G2->numVertex]();
-    G2->EI = new unsigned int[G2->numEdges];
+    G2->VI = new E[G2->numVertex+1];
+    G2->EI = new V[G2->numEdges > 0 ? G2->numEdges : 1];
+    G2->weights = (G1->weights != NULL) ? new unsigned int[G2->numEdges > 0 ? G2->numEdges : 1] : NULL;
 
-    for (unsigned int i=0; i<G1->numEdges; i++)
-    {
-        if (G1->EI[i] < G2->numVertex-1)
-            G2->VI[G1->EI[i]+1]++;
-    }
-    for (unsigned int i=1; i<G2->numVertex; i++)
-    {
-        G2->VI[i] += G2->VI[i-1];
-    }
+    parallelTranspose(G1->numVertex, [&](V u) { return (u == G1->numVertex) ? G1->numEdges : G1->VI[u]; },
+                      (const V*) G1->EI, G2->numVertex, G2->VI, G2->EI, (const unsigned int*) G1->weights, G2->weights);
+}
 
 
-    unsigned int* tempId = new unsigned int [G2->numVertex]();
+template <typename V, typename E>
+void permute_csr (graphT<V, E>* G, V* nodeId, V* nodeMap, graphT<V, E>* R)
+{
+    V n = G->numVertex;
+    R->numVertex = n;
+    R->numEdges = G->numEdges;
+    E* deg = new E [n];
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long i=start; i<end; i++)
+            deg[i] = G->VI[nodeId[i]+1] - G->VI[nodeId[i]];
+    });
+    R->VI = new E [n+1];
+    parallelPrefixSum(deg, R->VI, n);
+    delete[] deg;
+    R->EI = new V [R->numEdges > 0 ? R->numEdges : 1];
+    R->weights = (G->weights != NULL) ? new unsigned int [R->numEdges > 0 ? R->numEdges : 1] : NULL;
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long i=start; i<end; i++)
+        {
+            E parentStartId = G->VI[nodeId[i]];
+            for (E j=R->VI[i]; j<R->VI[i+1]; j++)
+            {
+                R->EI[j] = nodeMap[G->EI[parentStartId + (j - R->VI[i])]];
+                if (R->weights != NULL)
+                    R->weights[j] = G->weights[parentStartId + (j - R->VI[i])];
+            }
+        }
+    });
+}
 
-    for (unsigned int i=0; i<G1->numVertex; i++)
+template <typename V, typename E>
+void freeMem (graphT<V, E>* G)
+{
+    if (G->file != NULL)
     {
-        unsigned int maxId = (i==G1->numVertex-1) ? G1->numEdges : G1->VI[i+1];
-        for (unsigned int j=G1->VI[i]; j<maxId; j++)
+        if (--G->file->refs == 0)
         {
-            unsigned int node = G1->EI[j];
-            G2->EI[G2->VI[node] + tempId[node]] = i;
-            tempId[node]++;
+            close_bcsr(G->file);
+            delete G->file;
         }
     }
-    delete[] tempId;
+    else
+    {
+        delete[] G->VI;
+        delete[] G->EI;
+        delete[] G->weights;
+    }
+    G->VI = NULL;
+    G->EI = NULL;
+    G->weights = NULL;
+    G->file = NULL;
 }
 
-
-void freeMem (graph* G)
-{
-    delete[] G->VI;
-    delete[] G->EI;
-}
+#define INSTANTIATE_GRAPH(V, E) \
+    template int read_csr (char*, graphT<V, E>*, graphT<V, E>*); \
+    template void printGraph (graphT<V, E>*); \
+    template void write_edge_list (char*, graphT<V, E>*, V*); \
+    template int write_csr (char*, graphT<V, E>*); \
+    template int write_bcsr (char*, graphT<V, E>*, graphT<V, E>*); \
+    template void createReverseCSR (graphT<V, E>*, graphT<V, E>*, V); \
+    template void permute_csr (graphT<V, E>*, V*, V*, graphT<V, E>*); \
+    template void freeMem (graphT<V, E>*); \
+    template int write_permuted_edge_list (char*, graphT<V, E>*, V*, V*); \
+    template int write_serialized_graph (char*, graphT<V, E>*, graphT<V, E>*, V*, V*); \
+    template int write_relabeled_serialized_graph (char*, V*, V*, unsigned int*, E, V, const V*); \
+    template int read_edge_list (char*, V*&, V*&, unsigned int*&, E&, V&); \
+    template void build_csr (V*, V*, unsigned int*, E, V, graphT<V, E>*); \
+    template int write_relabeled_edge_list (char*, V*, V*, unsigned int*, E, const V*); \
+    template int write_original_order (const char*, graphT<V, E>*, const V*);
+
+INSTANTIATE_GRAPH(unsigned int, unsigned int)
+INSTANTIATE_GRAPH(unsigned int, unsigned long long)
+
+template int write_new_order (const char*, const unsigned int*, unsigned int);
+template int read_new_order (const char*, vector<unsigned int>&);
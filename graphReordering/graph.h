@@ -1,3 +1,4 @@
+#ifndef GRAPH_HEADER_INCL
 #include <iostream>
 #include <vector>
 #include <stdio.h>
@@ -5,33 +6,114 @@
 #include <cstdio>
 #include <string>
 #include <unordered_map>
+#include "csrfile.h"
 #define GRAPH_HEADER_INCL
 using namespace std;
 
 extern bool weighted, maintain, indegree;
 
-typedef struct graph
+// verify the section checksums when reading a .bcsr input
+extern bool verifyChecksum;
+
+// V is the vertex id type, E the edge offset type (VI entries, numEdges)
+template <typename V, typename E>
+struct graphT
 {
-    unsigned int numVertex;
-    unsigned int numEdges;
-    unsigned int* VI;
-    unsigned int* EI;
-    unordered_map<unsigned int, unsigned int> filtered_to_original;
-    unordered_map<string, unsigned int> weights;
-} graph;
+    V numVertex = 0;
+    E numEdges = 0;
+    E* VI = NULL;
+    V* EI = NULL;
+    // VI/EI point into this mapping instead of the heap when the
+    // graph was read from a .bcsr file
+    bcsrFile* file = NULL;
+    vector<V> filtered_to_original;
+    // weights[j] is the weight of EI[j], NULL when unweighted
+    unsigned int* weights = NULL;
+};
+
+// compact instantiation, used unless the graph has 2^32 edges or more
+typedef graphT<unsigned int, unsigned int> graph;
+// 64-bit edge offsets for big graphs
+typedef graphT<unsigned int, unsigned long long> graph64;
+
+// true if the file has to be read into a graph64: a .bcsr file with 8-byte
+// offsets or an edge list big enough to hold 2^32 edges
+bool needs_wide_offsets (const char*);
+
+// reads a text edge list or a .bcsr file, if rev is given and the
+// .bcsr file carries the in-csr, rev is filled with the reverse graph
+template <typename V, typename E>
+int read_csr (char*, graphT<V, E>*, graphT<V, E>* rev = NULL);
+
+// parses a text edge list in file order without compacting the ids,
+// numVertex is one past the largest id, weights is NULL unless weighted
+template <typename V, typename E>
+int read_edge_list (char*, V*&, V*&, unsigned int*&, E&, V&);
+
+// csr (the in-csr with --indegree) of an edge list read by read_edge_list,
+// the ids are not compacted, G gets numVertex rows
+template <typename V, typename E>
+void build_csr (V*, V*, unsigned int*, E, V, graphT<V, E>*);
+
+// writes "newId[src] newId[dst] [weight]" for every edge, in the given order
+template <typename V, typename E>
+int write_relabeled_edge_list (char*, V*, V*, unsigned int*, E, const V*);
+
+// new_order.el format read by the old python wrappers and relabel
+template <typename V>
+int write_new_order (const char*, const V*, V);
+
+// new_order.el over the input ids of G, newId is indexed by the compacted id
+template <typename V, typename E>
+int write_original_order (const char*, graphT<V, E>*, const V*);
+
+// reads one new id per line into order, "-" reads stdin
+template <typename V>
+int read_new_order (const char*, vector<V>&);
+
+template <typename V, typename E>
+void printGraph (graphT<V, E>*);
+
+template <typename V, typename E>
+void write_edge_list(char*, graphT<V, E>*, V *);
+
+// legacy layout, only available with 32-bit offsets
+template <typename V, typename E>
+int write_csr (char*, graphT<V, E>*);
 
-string get_map_key(unsigned int, unsigned int);
+// G must be the out-csr, rev its reverse (as built by createReverseCSR)
+template <typename V, typename E>
+int write_bcsr (char*, graphT<V, E>*, graphT<V, E>*);
 
-int read_csr (char*, graph*);
+// parallel transpose (see transpose.h), the reverse lists are sorted
+template <typename V, typename E>
+void createReverseCSR (graphT<V, E>*, graphT<V, E>*, V);
 
-void printGraph (graph*);
+// R gets G relabeled: vertex i of R is vertex nodeId[i] of G, neighbors are
+// mapped through nodeMap and keep their order, weights follow their edges
+template <typename V, typename E>
+void permute_csr (graphT<V, E>*, V*, V*, graphT<V, E>*);
 
-void write_edge_list(char*, graph*, unsigned int *);
+// same output as write_edge_list of permute_csr(G, nodeId, nodeMap), written row
+// by row straight from G without building the permuted csr
+template <typename V, typename E>
+int write_permuted_edge_list (char*, graphT<V, E>*, V*, V*);
 
-void write_csr (char*, graph*);
+// true for the gapbs serialized graph names (.sg, .wsg)
+bool is_serialized_graph (const char*);
 
-void initGraph (graph*);
+// gapbs .sg / .wsg (with weights) of G relabeled by nodeId / nodeMap (as for permute_csr),
+// in the layout Reader::ReadSerializedGraph reads: directed flag, edge and vertex
+// counts, out offsets and neighbors, in offsets and neighbors. rev is the reverse of G.
+// rows are sorted without duplicates and self loops, the same file the converter
+// makes from the relabeled edge list, without going through text
+template <typename V, typename E>
+int write_serialized_graph (char*, graphT<V, E>*, graphT<V, E>*, V*, V*);
 
-void createReverseCSR (graph*, graph*, unsigned int);
+// same for an edge list relabeled by newId (deg, relabel, incr)
+template <typename V, typename E>
+int write_relabeled_serialized_graph (char*, V*, V*, unsigned int*, E, V, const V*);
 
-void freeMem(graph*);
+template <typename V, typename E>
+void freeMem(graphT<V, E>*);
+#endif
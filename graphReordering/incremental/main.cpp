@@ -0,0 +1,544 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+#include "parallel.h"
+#include "countingsort.h"
+#include "locality.h"
+#ifndef GRAPH_HEADER_INCL
+#include "graph.h"
+#endif
+#include "../pH/phorder.h"
+#include "../degree/degorder.h"
+
+using namespace std;
+
+bool weighted = false, maintain = false, indegree = false;
+
+// ordering the previous permutation came from: degree, hub or ph
+const char* algo = "degree";
+// degree and hub options, as in deg
+bool ascending = false, hubSort = false;
+// pH cache size, as in ph
+unsigned int CACHE_SIZE = 100000;
+// pH: an old vertex is moved when at least this fraction of its edges is new
+double moveThreshold = 0.25;
+// window of the score in the drift report, as in metrics
+int window = 5;
+// also run the full reordering of the updated graph and report the drift
+bool compareFull = true;
+
+template <typename V, typename E>
+int update (char*, char*, char*, char*);
+
+int main(int argc, char** argv)
+{
+    if (argc < 5)
+    {
+        printf("Usage : %s <--algo degree|hub|ph(optional)> <--sort(optional)> <--ascending(optional)> <--cache n(optional)> <--threshold f(optional)> <--window n(optional)> <--no-compare(optional)> <--maintain(optional)> <--weighted(optional)> <--indegree(optional)> <--threads n(optional)> <previousOrder> <baseGraph> <deltaGraph> <outputFile>\n", argv[0]);
+        exit(1);
+    }
+    for (int i = 1; i < argc-4; i++){
+      char * opt = argv[i];
+      if (strcmp(opt, "-m") == 0 || strcmp(opt,"--maintain") == 0) maintain = true;
+      else if (strcmp(opt, "-i") == 0 || strcmp(opt,"--indegree") == 0) indegree = true;
+      else if (strcmp(opt, "-w") == 0 || strcmp(opt,"--weighted") == 0) weighted = true;
+      else if (strcmp(opt, "-a") == 0 || strcmp(opt,"--ascending") == 0) ascending = true;
+      else if (strcmp(opt, "-s") == 0 || strcmp(opt,"--sort") == 0) hubSort = true;
+      else if (strcmp(opt, "--no-compare") == 0) compareFull = false;
+      else if (strcmp(opt, "--algo") == 0 && i+1 < argc-4) algo = argv[++i];
+      else if ((strcmp(opt, "-c") == 0 || strcmp(opt,"--cache") == 0) && i+1 < argc-4) CACHE_SIZE = atoi(argv[++i]);
+      else if (strcmp(opt, "--threshold") == 0 && i+1 < argc-4) moveThreshold = atof(argv[++i]);
+      else if ((strcmp(opt, "-W") == 0 || strcmp(opt,"--window") == 0) && i+1 < argc-4) window = atoi(argv[++i]);
+      else if ((strcmp(opt, "-t") == 0 || strcmp(opt,"--threads") == 0) && i+1 < argc-4) numThreads = atoi(argv[++i]);
+    }
+    if (strcmp(algo, "degree") != 0 && strcmp(algo, "hub") != 0 && strcmp(algo, "ph") != 0)
+    {
+        fprintf(stderr, "unknown ordering %s, expected degree, hub or ph\n", algo);
+        exit(1);
+    }
+
+    // ids are not compacted, the edge count decides nothing here
+    return update<unsigned int, unsigned long long>(argv[argc-4], argv[argc-3], argv[argc-2], argv[argc-1]);
+}
+
+static double elapsed (struct timeval& start, struct timeval& end)
+{
+    return (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec)/1e6;
+}
+
+// per vertex counts of the base graph, what the run that wrote the previous order
+// knew about it, and the changes the delta makes to them
+template <typename V>
+struct vertexCounts
+{
+    // degree in the counted direction (out, in with -i)
+    V* oldDeg;
+    // in + out degree, for pH
+    V* oldTotal;
+    V* newTotal = NULL;
+    // shows up in the base graph
+    unsigned char* seen;
+    V oldSeen = 0;
+    unsigned long long oldEdges = 0;
+    // degree / hub: degree the delta adds and whether it touches a vertex
+    V* addDeg = NULL;
+    unsigned char* touched = NULL;
+    // hub: the vertices of the base graph by ascending degree
+    V* byDeg = NULL;
+    V numByDeg = 0;
+};
+
+// (group, key) of a vertex in a degree / hub order, orders are sorted by it.
+// the groups are the ones of deg:
+// degree: 0 vertices with edges, 1 vertices only seen as the other end, 2 unseen ids
+// hub:    0 hubs, 1 the other vertices that show up, 2 unseen ids
+// key is the degree where the group is sorted by degree, the id where it is in
+// id order and 0 where ties keep the order they had (first appearance)
+template <typename V>
+static inline unsigned long long orderKey (V v, V deg, bool seen, double avg, bool hub)
+{
+    unsigned long long group, key;
+    if (!seen)
+        group = 2;
+    else if (hub)
+        group = (deg >= avg) ? 0 : 1;
+    else
+        group = (deg > 0) ? 0 : 1;
+
+    if (group == 0 && (!hub || hubSort))
+        key = ascending ? deg : 0xffffffffULL - deg;
+    else if (group == 2 || hub)
+        key = v;
+    else
+        key = 0;
+    return (group << 32) | key;
+}
+
+// degree / hub order of the updated graph from the previous one, order[r] gets the
+// vertex at rank r. only the vertices the delta touches, the ids past the previous
+// order and (hub) the vertices whose hub status flips with the average are looked
+// at. the ones whose (group, key) changed are sorted and merged into the previous
+// order, which is still sorted by (group, key) for the others, equal keys keep the
+// old vertices first. the rest of the previous order is copied in blocks.
+// returns the number of sorted vertices
+template <typename V>
+static V repairDegree (vertexCounts<V>& C, const V* deltaSrc, const V* deltaDst, unsigned long long deltaEdges,
+                       V n, const V* prevOrder, const V* prevRank, V prevN, V* order)
+{
+    bool hub = strcmp(algo, "hub") == 0;
+    const V* deltaKey = indegree ? deltaDst : deltaSrc;
+
+    vector<V> touched;
+    V newSeen = C.oldSeen;
+    for (unsigned long long j=0; j<deltaEdges; j++)
+    {
+        C.addDeg[deltaKey[j]]++;
+        V ends[2] = {deltaSrc[j], deltaDst[j]};
+        for (int e=0; e<2; e++)
+        {
+            if (C.touched[ends[e]])
+                continue;
+            C.touched[ends[e]] = 1;
+            touched.push_back(ends[e]);
+            newSeen += !C.seen[ends[e]];
+        }
+    }
+
+    // hubs have at least the average degree over the vertices that show up
+    double oldAvg = (C.oldSeen == 0) ? 0 : (double) C.oldEdges / C.oldSeen;
+    double newAvg = (newSeen == 0) ? 0 : (double) (C.oldEdges + deltaEdges) / newSeen;
+    auto oldKey = [&](V v) { return orderKey(v, C.oldDeg[v], C.seen[v] != 0, oldAvg, hub); };
+    auto newKey = [&](V v) { return orderKey(v, C.oldDeg[v] + C.addDeg[v], C.seen[v] || C.touched[v], newAvg, hub); };
+
+    vector<V> check(touched);
+    for (V v=prevN; v<n; v++)
+        if (!C.touched[v])
+            check.push_back(v);
+    if (hub && C.numByDeg > 0)
+    {
+        // only a degree between the two averages is a hub on one side and not on the other
+        double lo = min(oldAvg, newAvg), hi = max(oldAvg, newAvg);
+        V* first = partition_point(C.byDeg, C.byDeg + C.numByDeg, [&](V v) { return C.oldDeg[v] < lo; });
+        V* last = partition_point(first, C.byDeg + C.numByDeg, [&](V v) { return C.oldDeg[v] < hi; });
+        for (V* p=first; p<last; p++)
+            if (!C.touched[*p])
+                check.push_back(*p);
+    }
+
+    // (key, id) sorted is what the stable sorts by degree and group over the id order give
+    vector<pair<unsigned long long, V> > moved;
+    for (V v : check)
+    {
+        unsigned long long k = newKey(v);
+        if (v >= prevN || k != oldKey(v))
+            moved.push_back(make_pair(k, v));
+    }
+    sort(moved.begin(), moved.end());
+
+    // previous ranks of the moved vertices, they are left out when the rest is copied
+    vector<V> removed;
+    for (size_t i=0; i<moved.size(); i++)
+        if (moved[i].second < prevN)
+            removed.push_back(prevRank[moved[i].second]);
+    sort(removed.begin(), removed.end());
+
+    V r = 0, cur = 0;
+    size_t next = 0;
+    auto copyUpTo = [&](V p) {
+        while (cur < p)
+        {
+            V stop = (next < removed.size() && removed[next] < p) ? removed[next] : p;
+            memcpy(order + r, prevOrder + cur, (stop - cur) * sizeof(V));
+            r += stop - cur;
+            cur = stop;
+            if (next < removed.size() && cur == removed[next])
+            {
+                cur++;
+                next++;
+            }
+        }
+    };
+
+    // the vertices that stay keep their key, so the previous order is sorted by the
+    // old keys and a moved vertex goes after the last rank whose old key isn't larger.
+    // with maintain vertex 0 sits in front of that sort
+    V sortedFrom = (maintain && prevN > 0 && prevOrder[0] == 0) ? 1 : 0;
+    for (size_t i=0; i<moved.size(); i++)
+    {
+        V lo = sortedFrom, hi = prevN;
+        while (lo < hi)
+        {
+            V mid = lo + (hi - lo) / 2;
+            if (oldKey(prevOrder[mid]) <= moved[i].first)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        copyUpTo(lo);
+        order[r++] = moved[i].second;
+    }
+    copyUpTo(prevN);
+
+    // as in deg, vertex 0 is moved to the front
+    if (maintain && n > 0)
+    {
+        V p = 0;
+        while (order[p] != 0)
+            p++;
+        memmove(order + 1, order, p * sizeof(V));
+        order[0] = 0;
+    }
+
+    for (V v : touched)
+    {
+        C.addDeg[v] = 0;
+        C.touched[v] = 0;
+    }
+    return moved.size();
+}
+
+// pH order of the updated graph from the previous one. pH places vertices with a
+// greedy cache model instead of sorting them, so there are no buckets to re-sort:
+// new vertices and old ones with at least moveThreshold of their edges new are taken
+// out and put right after the median previous rank of their neighbors that stay
+// (both directions), the others keep their relative order. vertices without such
+// a neighbor go to the end. G is the updated csr, R its reverse.
+// returns the number of moved vertices
+template <typename V, typename E>
+static V repairPh (vertexCounts<V>& C, graphT<V, E>* G, graphT<V, E>* R, V n, const V* prevOrder, const V* prevRank, V prevN, V* order)
+{
+    unsigned char* moved = new unsigned char [n];
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long v=start; v<end; v++)
+        {
+            V added = C.newTotal[v] - C.oldTotal[v];
+            moved[v] = v >= prevN || (added > 0 && added >= moveThreshold * C.newTotal[v]);
+        }
+    });
+    V* list = new V [n];
+    V numMoved = parallelPack(n, [&](unsigned long long v) { return moved[v] != 0; },
+                              [&](unsigned long long v) { return (V) v; }, list);
+
+    // anchor[v] is the previous rank v is placed after, prevN for the end
+    V* anchor = new V [n];
+    parallelFor(numMoved, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        vector<V> ranks;
+        for (unsigned long long i=start; i<end; i++)
+        {
+            V v = list[i];
+            ranks.clear();
+            for (E j=G->VI[v]; j<G->VI[v+1]; j++)
+                if (!moved[G->EI[j]])
+                    ranks.push_back(prevRank[G->EI[j]]);
+            for (E j=R->VI[v]; j<R->VI[v+1]; j++)
+                if (!moved[R->EI[j]])
+                    ranks.push_back(prevRank[R->EI[j]]);
+            if (ranks.empty())
+            {
+                anchor[v] = prevN;
+                continue;
+            }
+            nth_element(ranks.begin(), ranks.begin() + ranks.size()/2, ranks.end());
+            anchor[v] = ranks[ranks.size()/2];
+        }
+    });
+    parallelCountingSortBy(list, numMoved, anchor);
+
+    V j = 0, r = 0;
+    for (V p=0; p<prevN; p++)
+    {
+        V v = prevOrder[p];
+        if (moved[v])
+            continue;
+        order[r++] = v;
+        while (j < numMoved && anchor[list[j]] == p)
+            order[r++] = list[j++];
+    }
+    while (j < numMoved)
+        order[r++] = list[j++];
+
+    delete[] moved;
+    delete[] list;
+    delete[] anchor;
+    return numMoved;
+}
+
+// newId from the rank order, with maintain pH swaps vertex 0 with the vertex at
+// rank 0 (degree orders already moved it to the front)
+template <typename V>
+static void ranksToIds (const V* order, V n, V* newId)
+{
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long r=start; r<end; r++)
+            newId[order[r]] = r;
+    });
+    if (maintain && n > 0 && newId[0] != 0)
+    {
+        newId[order[0]] = newId[0];
+        newId[0] = 0;
+    }
+}
+
+template <typename V, typename E>
+int update (char* prevFile, char* baseFile, char* deltaFile, char* outFile)
+{
+    bool isPh = strcmp(algo, "ph") == 0;
+
+    // line v of the previous order holds the old id of vertex v
+    vector<V> prev;
+    if (read_new_order(prevFile, prev) < 0)
+        exit(1);
+    V prevN = prev.size();
+    V* prevOrder = new V [prevN];
+    V* prevRank = new V [prevN];
+    unsigned char* taken = new unsigned char [prevN]();
+    unsigned int bad = 0;
+    parallelFor(prevN, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long v=start; v<end; v++)
+        {
+            if (prev[v] >= prevN || __sync_lock_test_and_set(&taken[prev[v]], 1))
+            {
+                bad = 1;
+                continue;
+            }
+            prevOrder[prev[v]] = v;
+            prevRank[v] = prev[v];
+        }
+    });
+    delete[] taken;
+    vector<V>().swap(prev);
+    if (bad)
+    {
+        fputs("the previous order is not a permutation\n", stderr);
+        exit(1);
+    }
+
+    // edges are kept in file order, the updated graph is the base followed by the delta
+    V* baseSrc;
+    V* baseDst;
+    V* deltaSrc;
+    V* deltaDst;
+    unsigned int* baseWeights;
+    unsigned int* deltaWeights;
+    E baseEdges, deltaEdges;
+    V baseVertex, deltaVertex;
+    if (read_edge_list(baseFile, baseSrc, baseDst, baseWeights, baseEdges, baseVertex) < 0)
+        exit(1);
+    if (read_edge_list(deltaFile, deltaSrc, deltaDst, deltaWeights, deltaEdges, deltaVertex) < 0)
+        exit(1);
+
+    // an order of compacted ids has fewer lines than ids, it can't be lined up
+    if (prevN < baseVertex)
+    {
+        fprintf(stderr, "%s has %u entries but %s has %u ids, the order has to cover every id of the base graph\n",
+                prevFile, prevN, baseFile, baseVertex);
+        exit(1);
+    }
+
+    V n = max(max(baseVertex, deltaVertex), prevN);
+    E m = baseEdges + deltaEdges;
+    V* src = new V [m > 0 ? m : 1];
+    V* dst = new V [m > 0 ? m : 1];
+    unsigned int* weights = weighted ? new unsigned int [m > 0 ? m : 1] : NULL;
+    memcpy(src, baseSrc, baseEdges * sizeof(V));
+    memcpy(src + baseEdges, deltaSrc, deltaEdges * sizeof(V));
+    memcpy(dst, baseDst, baseEdges * sizeof(V));
+    memcpy(dst + baseEdges, deltaDst, deltaEdges * sizeof(V));
+    if (weighted)
+    {
+        memcpy(weights, baseWeights, baseEdges * sizeof(unsigned int));
+        memcpy(weights + baseEdges, deltaWeights, deltaEdges * sizeof(unsigned int));
+    }
+    delete[] baseSrc;
+    delete[] baseDst;
+    delete[] baseWeights;
+    delete[] deltaSrc;
+    delete[] deltaDst;
+    delete[] deltaWeights;
+
+    printf("file reading done. Num vertices = %d and numEdges = %llu (%llu new, %u new vertices)\n",
+           n, (unsigned long long) m, (unsigned long long) deltaEdges, n - prevN);
+
+    // the base graph as the run that wrote the previous order saw it, counted here
+    // while loading. the repair itself only looks at the delta
+    vertexCounts<V> C;
+    C.oldDeg = new V [n]();
+    C.oldTotal = new V [n]();
+    C.seen = new unsigned char [n]();
+    C.oldEdges = baseEdges;
+    V* key = indegree ? dst : src;
+    parallelFor(baseEdges, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long j=start; j<end; j++)
+        {
+            __sync_fetch_and_add(&C.oldDeg[key[j]], 1);
+            __sync_fetch_and_add(&C.oldTotal[src[j]], 1);
+            __sync_fetch_and_add(&C.oldTotal[dst[j]], 1);
+            if (!__sync_lock_test_and_set(&C.seen[src[j]], 1))
+                __sync_fetch_and_add(&C.oldSeen, 1);
+            if (!__sync_lock_test_and_set(&C.seen[dst[j]], 1))
+                __sync_fetch_and_add(&C.oldSeen, 1);
+        }
+    });
+    if (!isPh)
+    {
+        C.addDeg = new V [n]();
+        C.touched = new unsigned char [n]();
+    }
+    if (strcmp(algo, "hub") == 0)
+    {
+        C.byDeg = new V [n];
+        C.numByDeg = parallelPack(n, [&](unsigned long long v) { return C.seen[v] != 0; },
+                                  [&](unsigned long long v) { return (V) v; }, C.byDeg);
+        parallelCountingSortBy(C.byDeg, C.numByDeg, C.oldDeg);
+    }
+
+    // pH and the report need the updated csr and its reverse
+    graphT<V, E> G, R;
+    if (isPh || compareFull)
+    {
+        build_csr(src, dst, (unsigned int*) NULL, m, n, &G);
+        createReverseCSR(&G, &R, n);
+    }
+
+    struct timeval start, end;
+    V* order = new V [n];
+    gettimeofday(&start, NULL);
+    V numMoved;
+    if (isPh)
+    {
+        C.newTotal = new V [n];
+        memcpy(C.newTotal, C.oldTotal, n * sizeof(V));
+        parallelFor(deltaEdges, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+            for (unsigned long long j=baseEdges+start; j<baseEdges+end; j++)
+            {
+                __sync_fetch_and_add(&C.newTotal[src[j]], 1);
+                __sync_fetch_and_add(&C.newTotal[dst[j]], 1);
+            }
+        });
+        numMoved = repairPh(C, &G, &R, n, prevOrder, prevRank, prevN, order);
+    }
+    else
+        numMoved = repairDegree(C, src + baseEdges, dst + baseEdges, deltaEdges, n, prevOrder, prevRank, prevN, order);
+    V* newId = new V [n];
+    ranksToIds(order, n, newId);
+    gettimeofday(&end, NULL);
+    double repairTime = elapsed(start, end);
+
+    printf("%s, %lf \n", outFile, repairTime);
+    printf("repaired %u of %u vertices\n", numMoved, n);
+
+    if (write_new_order("new_order.el", newId, n) < 0)
+        exit(1);
+    if (is_serialized_graph(outFile))
+    {
+        if (write_relabeled_serialized_graph(outFile, src, dst, weights, m, n, (const V*) newId) < 0)
+            exit(1);
+    }
+    else if (write_relabeled_edge_list(outFile, src, dst, weights, m, newId) < 0)
+        exit(1);
+
+    if (compareFull)
+    {
+        graphT<V, E>* in = indegree ? &G : &R;
+        V* otherId = new V [n];
+
+        printf("order, gap cost, window score, time\n");
+        // the previous order as it is, new vertices appended in id order
+        for (V r=0; r<n; r++)
+            order[r] = (r < prevN) ? prevOrder[r] : r;
+        ranksToIds(order, n, otherId);
+        localityMetrics P = measureLocality(&G, in, otherId, window);
+        printf("previous, %lf, %llu, 0\n", P.gapCost, P.windowScore);
+
+        localityMetrics I = measureLocality(&G, in, newId, window);
+        printf("incremental, %lf, %llu, %lf\n", I.gapCost, I.windowScore, repairTime);
+
+        // the full order is what ph / deg compute on the updated graph
+        gettimeofday(&start, NULL);
+        if (isPh)
+            phOrder(&G, &R, (V) sqrt(n), CACHE_SIZE, order);
+        else
+            degreeOrder(src, dst, m, n, strcmp(algo, "hub") == 0, order);
+        ranksToIds(order, n, otherId);
+        gettimeofday(&end, NULL);
+        localityMetrics F = measureLocality(&G, in, otherId, window);
+        printf("full, %lf, %llu, %lf\n", F.gapCost, F.windowScore, elapsed(start, end));
+        V differ = 0;
+        for (V v=0; v<n; v++)
+            differ += (otherId[v] != newId[v]);
+        printf("%u of %u vertices got another id than in the full order\n", differ, n);
+
+        // positive gap cost drift and negative score drift are losses
+        printf("drift vs full: gap cost %+.3lf%%, window score %+.3lf%%\n",
+               (F.gapCost == 0) ? 0 : 100.0 * (I.gapCost - F.gapCost) / F.gapCost,
+               (F.windowScore == 0) ? 0 : 100.0 * ((double) I.windowScore - (double) F.windowScore) / F.windowScore);
+        delete[] otherId;
+    }
+
+    if (isPh || compareFull)
+    {
+        freeMem(&G);
+        freeMem(&R);
+    }
+    delete[] C.oldDeg;
+    delete[] C.oldTotal;
+    delete[] C.newTotal;
+    delete[] C.seen;
+    delete[] C.addDeg;
+    delete[] C.touched;
+    delete[] C.byDeg;
+    delete[] order;
+    delete[] newId;
+    delete[] prevOrder;
+    delete[] prevRank;
+    delete[] src;
+    delete[] dst;
+    delete[] weights;
+
+    return 0;
+}
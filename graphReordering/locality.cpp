@@ -0,0 +1,209 @@
+#include "locality.h"
+#include "parallel.h"
+#include <algorithm>
+#include <math.h>
+
+using namespace std;
+
+static inline unsigned int log2Floor (unsigned long long x)
+{
+    return 63 - __builtin_clzll(x);
+}
+
+// size of the sorted lists' intersection
+template <typename V>
+static unsigned long long intersectionSize (const V* a, unsigned long long na, const V* b, unsigned long long nb)
+{
+    unsigned long long i = 0, j = 0, common = 0;
+    while (i < na && j < nb)
+    {
+        if (a[i] < b[j])
+            i++;
+        else if (a[i] > b[j])
+            j++;
+        else
+        {
+            common++;
+            i++;
+            j++;
+        }
+    }
+    return common;
+}
+
+template <typename V, typename E>
+localityMetrics measureLocality (graphT<V, E>* G, graphT<V, E>* in, const V* newId, int window)
+{
+    V n = G->numVertex;
+    unsigned int T = (numThreads == 0) ? 1 : numThreads;
+
+    // per thread partial sums, combined below
+    vector<double> gapLog(T, 0), bits(T, 0), spread(T, 0);
+    vector<unsigned long long> band(T, 0), prof(T, 0), rows(T, 0);
+    parallelFor(n, T, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        vector<V> nbrs;
+        for (unsigned long long v=start; v<end; v++)
+        {
+            E first = G->VI[v], last = G->VI[v+1];
+            if (first == last)
+                continue;
+            nbrs.clear();
+            for (E j=first; j<last; j++)
+                nbrs.push_back(newId[G->EI[j]]);
+            sort(nbrs.begin(), nbrs.end());
+
+            unsigned long long self = newId[v];
+            unsigned long long lo = nbrs.front(), hi = nbrs.back();
+            unsigned long long firstGap = (lo > self) ? lo - self : self - lo;
+            bits[tid] += log2Floor(firstGap + 1) + 1;
+            for (size_t k=1; k<nbrs.size(); k++)
+            {
+                unsigned long long gap = nbrs[k] - nbrs[k-1];
+                if (gap > 0)
+                    gapLog[tid] += log2((double) gap);
+                bits[tid] += log2Floor(gap + 1) + 1;
+            }
+
+            unsigned long long far = max(hi > self ? hi - self : self - hi, firstGap);
+            if (far > band[tid])
+                band[tid] = far;
+            if (lo < self)
+                prof[tid] += self - lo;
+            spread[tid] += hi - lo;
+            rows[tid]++;
+        }
+    });
+
+    // the window score needs sorted in-lists, the csr of an edge list keeps the
+    // input order of its edges, so unsorted rows are sorted in a copy
+    vector<unsigned char> unsortedRows(T, 0);
+    parallelFor(n, T, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long v=start; v<end && !unsortedRows[tid]; v++)
+            if (!is_sorted(in->EI + in->VI[v], in->EI + in->VI[v+1]))
+                unsortedRows[tid] = 1;
+    });
+    const V* inEI = in->EI;
+    V* sortedEI = NULL;
+    if (find(unsortedRows.begin(), unsortedRows.end(), 1) != unsortedRows.end())
+    {
+        sortedEI = new V [in->numEdges];
+        parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+            for (unsigned long long v=start; v<end; v++)
+            {
+                copy(in->EI + in->VI[v], in->EI + in->VI[v+1], sortedEI + in->VI[v]);
+                sort(sortedEI + in->VI[v], sortedEI + in->VI[v+1]);
+            }
+        });
+        inEI = sortedEI;
+    }
+
+    // position -> vertex, to walk the order
+    V* vertexAt = new V [n];
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long v=start; v<end; v++)
+            vertexAt[newId[v]] = v;
+    });
+    vector<unsigned long long> score(T, 0);
+    parallelFor(n, T, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long i=start; i<end; i++)
+        {
+            V a = vertexAt[i];
+            const V* inA = inEI + in->VI[a];
+            E degA = in->VI[a+1] - in->VI[a];
+            for (unsigned long long j=(i > (unsigned long long) window) ? i-window : 0; j<i; j++)
+            {
+                V b = vertexAt[j];
+                const V* inB = inEI + in->VI[b];
+                E degB = in->VI[b+1] - in->VI[b];
+                score[tid] += intersectionSize(inA, degA, inB, degB);
+                if (binary_search(inA, inA + degA, b))
+                    score[tid]++;
+                if (binary_search(inB, inB + degB, a))
+                    score[tid]++;
+            }
+        }
+    });
+    delete[] vertexAt;
+    delete[] sortedEI;
+
+    localityMetrics M;
+    unsigned long long nonEmpty = 0;
+    for (unsigned int t=0; t<T; t++)
+    {
+        M.gapCost += gapLog[t];
+        M.bitsPerEdge += bits[t];
+        M.windowScore += score[t];
+        M.bandwidth = max(M.bandwidth, band[t]);
+        M.profile += prof[t];
+        M.avgSpread += spread[t];
+        nonEmpty += rows[t];
+    }
+    if (G->numEdges > 0)
+    {
+        M.gapCost /= G->numEdges;
+        M.bitsPerEdge /= G->numEdges;
+    }
+    if (nonEmpty > 0)
+        M.avgSpread /= nonEmpty;
+    return M;
+}
+
+template <typename V, typename E>
+bool orderNewIds (graphT<V, E>* G, const vector<V>& order, V* newId)
+{
+    V n = G->numVertex;
+    bool mapped = (G->filtered_to_original.size() == n);
+
+    // the order has to be a permutation of the original ids [0, N), shorter ones are
+    // rejected (an order of the compacted ids would pass for one), as in spmplan's readOrder
+    unsigned long long N = (n == 0) ? 0 : (unsigned long long) (mapped ? G->filtered_to_original[n-1] : n-1) + 1;
+    if (order.empty())
+    {
+        parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+            for (unsigned long long v=start; v<end; v++)
+                newId[v] = v;
+        });
+        return true;
+    }
+    if (order.size() < N)
+        return false;
+    N = order.size();
+    unsigned char* seen = new unsigned char [N]();
+    unsigned int T = (numThreads == 0) ? 1 : numThreads;
+    vector<unsigned char> bad(T, 0);
+    parallelFor(N, T, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long o=start; o<end; o++)
+            if (order[o] >= N || __sync_lock_test_and_set(&seen[order[o]], 1))
+                bad[tid] = 1;
+    });
+    delete[] seen;
+    if (find(bad.begin(), bad.end(), 1) != bad.end())
+        return false;
+
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long v=start; v<end; v++)
+            newId[v] = order[mapped ? G->filtered_to_original[v] : v];
+    });
+    // vertices missing from the graph leave holes in the ids, they are closed up
+    // keeping the order (the ids are distinct now)
+    if (N > n)
+    {
+        V* rank = new V [n];
+        for (V v=0; v<n; v++)
+            rank[v] = v;
+        sort(rank, rank + n, [&](V a, V b) { return newId[a] < newId[b]; });
+        parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+            for (unsigned long long r=start; r<end; r++)
+                newId[rank[r]] = r;
+        });
+        delete[] rank;
+    }
+    return true;
+}
+
+#define INSTANTIATE_LOCALITY(V, E) \
+    template localityMetrics measureLocality (graphT<V, E>*, graphT<V, E>*, const V*, int); \
+    template bool orderNewIds (graphT<V, E>*, const vector<V>&, V*);
+
+INSTANTIATE_LOCALITY(unsigned int, unsigned int)
+INSTANTIATE_LOCALITY(unsigned int, unsigned long long)
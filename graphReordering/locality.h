@@ -0,0 +1,35 @@
+#ifndef LOCALITY_HEADER_INCL
+#define LOCALITY_HEADER_INCL
+
+#include "graph.h"
+
+struct localityMetrics
+{
+    // Gorder's gap cost: average log2 of the gaps between sorted neighbor ids
+    double gapCost = 0;
+    // gap encoded adjacency size, the first neighbor is coded against the vertex itself
+    double bitsPerEdge = 0;
+    // Gorder's score F: shared in-neighbors plus edges within the window
+    unsigned long long windowScore = 0;
+    // largest |id(u) - id(v)| over the edges
+    unsigned long long bandwidth = 0;
+    // sum over the rows of id(v) - the smallest neighbor id below it
+    unsigned long long profile = 0;
+    // average over the vertices with neighbors of max - min neighbor id
+    double avgSpread = 0;
+};
+
+// G is the csr the gaps are measured on, in the in-csr of the same graph, newId[v]
+// is the id of vertex v in the ordering being evaluated, a permutation of [0, n).
+// pairs at most window apart in the order count for the window score
+template <typename V, typename E>
+localityMetrics measureLocality (graphT<V, E>*, graphT<V, E>*, const V*, int);
+
+// newId[v] for the vertices of G from an order over the original ids (line i: new id of
+// vertex i). ids were compacted while reading, the ids are closed up to [0, n) when the
+// input has vertices without edges. An empty order keeps the input ids. false if the
+// order is not a permutation of the original ids or does not cover all of them
+template <typename V, typename E>
+bool orderNewIds (graphT<V, E>*, const vector<V>&, V*);
+
+#endif
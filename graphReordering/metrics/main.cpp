@@ -0,0 +1,101 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+#include "parallel.h"
+#include "locality.h"
+#ifndef GRAPH_HEADER_INCL
+#include "graph.h"
+#endif
+
+using namespace std;
+
+bool weighted = false, maintain = false, indegree = false;
+
+// pairs of vertices at most this far apart in the order are scored, as in Gorder
+int window = 5;
+
+template <typename V, typename E>
+int evaluate (char*, vector<char*>&);
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage : %s <--window n(optional)> <--indegree(optional)> <--threads n(optional)> <inputFile1> <orderFile ...(optional)>\n", argv[0]);
+        exit(1);
+    }
+    int i = 1;
+    for (; i < argc-1; i++){
+      char * opt = argv[i];
+      if (strcmp(opt, "-i") == 0 || strcmp(opt,"--indegree") == 0) indegree = true;
+      else if ((strcmp(opt, "-W") == 0 || strcmp(opt,"--window") == 0) && i+1 < argc-1) window = atoi(argv[++i]);
+      else if ((strcmp(opt, "-t") == 0 || strcmp(opt,"--threads") == 0) && i+1 < argc-1) numThreads = atoi(argv[++i]);
+      else if (strcmp(opt, "--verify") == 0) verifyChecksum = true;
+      else break;
+    }
+
+    char* inFile = argv[i];
+    vector<char*> orders(argv + i + 1, argv + argc);
+
+    if (needs_wide_offsets(inFile))
+        return evaluate<unsigned int, unsigned long long>(inFile, orders);
+    return evaluate<unsigned int, unsigned int>(inFile, orders);
+}
+
+template <typename V, typename E>
+int evaluate (char* inFile, vector<char*>& orderFiles)
+{
+    graphT<V, E> G1, G2;
+
+    // read csr file, a .bcsr input also brings the reverse csr along
+    if (read_csr(inFile, &G1, &G2)==-1)
+        exit(1);
+
+    printf("file reading done. Num vertices = %d and numEdges = %llu\n", G1.numVertex, (unsigned long long) G1.numEdges);
+
+    if (G2.VI == NULL)
+        createReverseCSR(&G1, &G2, G1.numVertex);
+    graphT<V, E>* in = indegree ? &G1 : &G2;
+
+    V n = G1.numVertex;
+
+    // without an order file the input is evaluated with its own ids
+    if (orderFiles.empty())
+        orderFiles.push_back(NULL);
+
+    printf("order, gap cost, bits/edge, window score, bandwidth, profile, avg spread, time\n");
+    V* newId = new V [n];
+    for (size_t f=0; f<orderFiles.size(); f++)
+    {
+        vector<V> order;
+        if (orderFiles[f] != NULL && read_new_order(orderFiles[f], order) < 0)
+            exit(1);
+
+        struct timeval start, end;
+        gettimeofday(&start, NULL);
+
+        if (!orderNewIds(&G1, order, newId))
+        {
+            fprintf(stderr, "%s is not an order of the vertices of %s\n", orderFiles[f], inFile);
+            exit(1);
+        }
+
+        localityMetrics M = measureLocality(&G1, in, newId, window);
+        gettimeofday(&end, NULL);
+
+        printf("%s, %lf, %lf, %llu, %llu, %llu, %lf, %lf\n", (orderFiles[f] != NULL) ? orderFiles[f] : inFile,
+               M.gapCost, M.bitsPerEdge, M.windowScore, M.bandwidth, M.profile, M.avgSpread,
+               (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec)/1e6);
+    }
+
+    delete[] newId;
+    freeMem(&G1);
+    freeMem(&G2);
+
+    return 0;
+}
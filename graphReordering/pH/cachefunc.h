@@ -4,7 +4,17 @@
 #include <math.h>
 #include "graph.h"
 
-unsigned int evictParents (unsigned int, graph*, graph*, unsigned int*, unsigned int*, unsigned int*, bool*, unsigned int*, unsigned int*, unsigned int*, unsigned int*, unsigned int);
-unsigned int loadParents (unsigned int, graph*, graph*, unsigned int*, unsigned int*, unsigned int*, bool*, unsigned int*, unsigned int*, unsigned int*, unsigned int*, unsigned int, unsigned int);
-void moveRight(unsigned int, unsigned int*, unsigned int*, unsigned int*, unsigned int*, unsigned int);
-void moveLeft(unsigned int, unsigned int*, unsigned int*, unsigned int*, unsigned int*, unsigned int);
+// V is the vertex id type, E the edge offset type of the graph
+template <typename V, typename E>
+V evictParents (V, graphT<V, E>*, graphT<V, E>*, V*, V*, V*, bool*, V*, V*, V*, V*, V);
+template <typename V, typename E>
+V loadParents (V, graphT<V, E>*, graphT<V, E>*, V*, V*, V*, bool*, V*, V*, V*, V*, V, V);
+// replays the parent accesses of the order in nodeId against an lru cache of
+// cacheSize vertices and returns the number of misses, parents with more than
+// thresh children are skipped like in the pH cost model
+template <typename V, typename E>
+unsigned long long lruMisses (graphT<V, E>*, graphT<V, E>*, V*, V, unsigned int);
+template <typename V>
+void moveRight(V, V*, V*, V*, V*, V);
+template <typename V>
+void moveLeft(V, V*, V*, V*, V*, V);
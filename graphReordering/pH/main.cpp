@@ -3,9 +3,10 @@
 #include <stdlib.h>
 #include <math.h>
 #include <sys/time.h>
-#include "sort.h"
 #include <utility>
 #include "cachefunc.h"
+#include "phorder.h"
+#include "parallel.h"
 #include <bits/stdc++.h>
 #ifndef GRAPH_HEADER_INCL
 #include "graph.h"
@@ -15,10 +16,23 @@
 #undef DEBUG
 
 unsigned int CACHE_SIZE = 100000;
+// > 1 runs the partitioned parallel mode
+unsigned int numParts = 0;
+// also run the sequential order to report the quality loss
+bool compareSequential = false;
+// > 0 runs the out-of-core mode within this many bytes
+unsigned long long memBudget = 0;
 
 using namespace std;
 
-void dumpNewOrder (graph*, unsigned int*, char*);
+template <typename V, typename E>
+void dumpNewOrder (graphT<V, E>*, V*, char*);
+
+template <typename V, typename E>
+int reorder (char*, char*);
+
+template <typename V, typename E>
+void reportQuality (graphT<V, E>*, graphT<V, E>*, V, V*);
 
 bool weighted = false, maintain = false, indegree = false;
 
@@ -31,7 +45,7 @@ int main(int argc, char** argv)
     }
     else if (argc != 3)
     {
-        printf("Usage : %s <cacheCapacity(optional)> <--maintain(optional)> <--weighted(opetional)> <--indegree(optional)> <inputFile1> <outputFile>\n", argv[0]);
+        printf("Usage : %s <cacheCapacity(optional)> <--maintain(optional)> <--weighted(opetional)> <--indegree(optional)> <--threads n(optional)> <--partitions n(optional)> <--compare(optional)> <--budget MB(optional)> <--verify(optional)> <inputFile1> <outputFile>\n", argv[0]);
         exit(1);
     }
     for (int i = 2; i < argc-2; i++){
@@ -39,216 +53,141 @@ int main(int argc, char** argv)
       if (strcmp(opt, "-m") == 0 || strcmp(opt,"--maintain") == 0) maintain = true;
       else if (strcmp(opt, "-i") == 0 || strcmp(opt,"--indegree") == 0) indegree = true;
       else if (strcmp(opt, "-w") == 0 || strcmp(opt,"--weighted") == 0) weighted = true;
+      else if ((strcmp(opt, "-t") == 0 || strcmp(opt,"--threads") == 0) && i+1 < argc-2) numThreads = atoi(argv[++i]);
+      else if ((strcmp(opt, "-p") == 0 || strcmp(opt,"--partitions") == 0) && i+1 < argc-2) numParts = atoi(argv[++i]);
+      else if (strcmp(opt, "--compare") == 0) compareSequential = true;
+      else if ((strcmp(opt, "-b") == 0 || strcmp(opt,"--budget") == 0) && i+1 < argc-2) memBudget = strtoull(argv[++i], NULL, 10) << 20;
+      else if (strcmp(opt, "--verify") == 0) verifyChecksum = true;
       // cout << *opt;
       cout << maintain << " " << indegree << " " << weighted << endl;
     }
-    // graph objects
-    graph G1, G2;
 
-    // read csr file
-    if (read_csr(argv[argc-2], &G1)==-1)
-        exit(1);
-
-    unsigned int degThresh = sqrt(G1.numVertex);
-//    unsigned int degThresh = G1.numVertex + 1;
-
-    unsigned int* deg = new unsigned int [G1.numVertex];
-    for (unsigned int i=0; i<G1.numVertex-1; i++)
-        deg[i] = G1.VI[i+1] - G1.VI[i];
-
-    deg[G1.numVertex-1] = G1.numEdges - G1.VI[G1.numVertex-1];
+    // 64-bit edge offsets only when the graph needs them
+    if (needs_wide_offsets(argv[argc-2]))
+        return reorder<unsigned int, unsigned long long>(argv[argc-2], argv[argc-1]);
+    return reorder<unsigned int, unsigned int>(argv[argc-2], argv[argc-1]);
+}
 
+template <typename V, typename E>
+int reorderStreaming (char* inFile, char* outFile)
+{
+    // the rows stay in the mapping, only the out-csr is needed
+    graphT<V, E> G1;
+    if (read_csr(inFile, &G1)==-1)
+        exit(1);
+    if (G1.file == NULL)
+    {
+        fputs("--budget needs a .bcsr input, convert the edge list with csr_gen first\n", stderr);
+        exit(1);
+    }
+    if (is_serialized_graph(outFile))
+    {
+        fputs("--budget writes an edge list, the .sg / .wsg output needs the whole graph in memory\n", stderr);
+        exit(1);
+    }
+    V degThresh = sqrt(G1.numVertex);
 
-    printf("file reading done. Num vertices = %d and numEdges = %d\n", G1.numVertex, G1.numEdges);
+    printf("file reading done. Num vertices = %d and numEdges = %llu\n", G1.numVertex, (unsigned long long) G1.numEdges);
 
+    // the O(n) part comes off the budget first: nodeId, nodeMap, the original ids
+    // read_csr keeps and at most one window start per vertex
+    unsigned long long fixedBytes = 4ULL * sizeof(V) * (G1.numVertex + 1);
+    if (memBudget <= fixedBytes)
+    {
+        fprintf(stderr, "--budget %llu MB is below the %llu MB the order itself needs\n", memBudget >> 20, (fixedBytes >> 20) + 1);
+        exit(1);
+    }
 
-    // another csr that stores edges in reverse direction
-    // to access children of a node
-    createReverseCSR(&G1, &G2);
+    V* nodeId = new V [G1.numVertex];
 
-    unsigned int* revDeg = new unsigned int [G1.numVertex];
-    for (unsigned int i=0; i<G2.numVertex-1; i++)
-        revDeg[i] = G2.VI[i+1] - G2.VI[i];
-    revDeg[G2.numVertex-1] = G2.numEdges - G2.VI[G2.numVertex-1];
+    struct timeval start, end;
+    gettimeofday(&start, NULL);
+    phOrderStreaming(&G1, degThresh, CACHE_SIZE, memBudget - fixedBytes, nodeId);
+    gettimeofday(&end, NULL);
 
+    printf("%s, %lf \n", outFile, (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec)/1e6);
 
+    V* nodeMap = new V [G1.numVertex];
+    for (V i=0; i<G1.numVertex; i++)
+        nodeMap[nodeId[i]] = i;
 
-    //initialize the cost array by degree of each vertex
-    unsigned int* cost = new unsigned int [G1.numVertex]();
-    unsigned int maxCost = 0;
-    for (unsigned int i=0; i<G1.numVertex; i++)
-    {
-        unsigned int endId = G1.VI[i+1];
-        for (unsigned int j=G1.VI[i]; j<endId; j++)
-        {
-            if (revDeg[G1.EI[j]] <= degThresh)
-                cost[i]++;
-        }
-        if (cost[i] > maxCost)
-            maxCost = cost[i];
+  if (maintain && nodeMap[0] != 0) {
+    V zeros_map = nodeMap[0];
+    nodeMap[0] = 0;
+    nodeId[0] = 0;
+    for(V i = 1; i < G1.numVertex; ++i){
+      if (nodeMap[i] == 0) {
+        nodeMap[i] = zeros_map;
+        nodeId[zeros_map] = i;
+        cout << "Mapped " << i << " to " << zeros_map << endl;
+        break;
+      }
     }
+  }
 
-    unsigned int* updates = new unsigned int [G1.numVertex]();
-
+	dumpNewOrder(&G1, nodeMap, (char *)"newOrder.bin");
+    if (write_original_order("new_order.el", &G1, (const V*) nodeMap) < 0)
+        exit(1);
 
-    // nodeIds keep track of what was the original position of a node in the vertex array
-    unsigned int* nodeId = new unsigned int [G1.numVertex];
-    for (unsigned int i=0; i<G1.numVertex; i++)
-        nodeId[i] = i;
+    // no permuted copy of the graph, the rows are relabeled as they are written
+    write_permuted_edge_list(outFile, &G1, nodeId, nodeMap);
+    delete[] nodeId;
+    delete[] nodeMap;
+    freeMem(&G1);
 
-    mergeSort(cost, nodeId, 0, G1.numVertex-1);
+    return 0;
+}
 
+template <typename V, typename E>
+int reorder (char* inFile, char* outFile)
+{
+    if (memBudget > 0)
+        return reorderStreaming<V, E>(inFile, outFile);
 
-    for (unsigned int i=0; i<G1.numVertex; i++)
-        cost[i] = maxCost;
+    // graph objects
+    graphT<V, E> G1, G2;
 
+    // read csr file, a .bcsr input also brings the reverse csr along
+    if (read_csr(inFile, &G1, &G2)==-1)
+        exit(1);
 
+    V degThresh = sqrt(G1.numVertex);
+//    unsigned int degThresh = G1.numVertex + 1;
 
+    printf("file reading done. Num vertices = %d and numEdges = %llu\n", G1.numVertex, (unsigned long long) G1.numEdges);
 
-#ifdef DEBUG
-    printf("sorting done\n");
-#endif
 
+    // another csr that stores edges in reverse direction
+    // to access children of a node
+    if (G2.VI == NULL)
+        createReverseCSR(&G1, &G2, G1.numVertex);
 
+    // nodeIds keep track of what was the original position of a node in the vertex array
+    V* nodeId = new V [G1.numVertex];
 
+    struct timeval start, end;
+    gettimeofday(&start, NULL);
+    if (numParts > 1)
+        phOrderPartitioned(&G1, &G2, degThresh, CACHE_SIZE, numParts, nodeId);
+    else
+        phOrder(&G1, &G2, degThresh, CACHE_SIZE, nodeId);
+    gettimeofday(&end, NULL);
 
-    clock_t start, end;
-    start = clock();
-    // CI -> array to keep pounsigned inters of start and end positions of a particular value in cost array
-    // eg. cost array = [0, 0, 1, 1, 3, 4, 4, 7]
-    // then CI = [0, 2, 4, 4, 5, 7, 7, 7]
-    // this array will be used in updating cost array in const time so that it always remains sorted
-    unsigned int* CI = new unsigned int [maxCost+1];
-    unsigned int val = 0;
-    CI[0] = 0;
-    unsigned int myId = 0;
-    while(val < maxCost)
-    {
-        while(cost[myId] == val)
-            myId++;
-        while(cost[myId] != val)
-            CI[++val] = myId;
-        myId++;
-    }
+    printf("%s, %lf \n", outFile, (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec)/1e6);
 
-#ifdef DEBUG
-    printf("cache model created\n");
-#endif
+    if (numParts > 1)
+        reportQuality(&G1, &G2, degThresh, nodeId);
 
     // nodeMap gives the new position of a vertex in the node array
-    unsigned int* nodeMap = new unsigned int [G1.numVertex];
-    for (unsigned int i=0; i<G1.numVertex; i++)
+    V* nodeMap = new V [G1.numVertex];
+    for (V i=0; i<G1.numVertex; i++)
         nodeMap[nodeId[i]] = i;
 
-#ifdef DEBUG
-    printf("node mapping computed\n");
-#endif
-
-    //keeps track of number of nodes in cache
-    //if greater than cache size, need to evict
-    unsigned int currWinCost = 0;
-    //keeps track of oldest node whose parents
-    //are still in cache
-    unsigned int currWinStartId = 0;
-    unsigned int* cachePresence = new unsigned int [G1.numVertex]();
-
-    //array to tell if a node is already processed
-    //cost of these nodes shouldn't be updated and they
-    //shouldn't be bought back unsigned into processing
-    bool* isPlaced = new bool [G1.numVertex]();
-    //array to store the reordered nodeIds
-    // place the lowest cost node first
-    unsigned int minPtr = 0;
-
-
-
-    while(minPtr < G1.numVertex)
-    {
-        if (minPtr >= G1.numVertex-2)
-            break;
-        unsigned int origId = nodeId[minPtr];
-        unsigned int nodeCost = deg[origId] - (maxCost - cost[minPtr]);
-        while(updates[origId] > 0)
-        {
-            updates[origId]--;
-            moveRight(origId, cost, nodeMap, nodeId, CI, minPtr);
-            origId = nodeId[minPtr];
-        }
-        if (deg[origId] > CACHE_SIZE)
-        {
-        //special case, handle separately
-            isPlaced[origId] = true;
-            minPtr++;
-            continue;
-        }
-        while((currWinCost + nodeCost > CACHE_SIZE) && (currWinStartId < minPtr-5))
-        {
-            //evict
-            if (deg[nodeId[currWinStartId]] <= CACHE_SIZE)
-                currWinCost -= evictParents(currWinStartId, &G1, &G2, CI, cost, cachePresence, isPlaced, nodeId, nodeMap, revDeg, updates, degThresh);
-            origId = nodeId[minPtr];
-            while(updates[origId] > 0)
-            {
-                updates[origId]--;
-                moveRight(origId, cost, nodeMap, nodeId, CI, minPtr);
-                origId = nodeId[minPtr];
-            }
-            nodeCost = deg[origId] - (maxCost - cost[minPtr]);
-            currWinStartId++;
-            if (deg[origId] > CACHE_SIZE)
-            {
-            //special case, handle separately
-                break;
-            }
-        }
-        if (deg[origId] > CACHE_SIZE)
-        {
-            isPlaced[origId] = true;
-            minPtr++;
-            continue;
-        }
-        while(updates[origId] > 0)
-        {
-            updates[origId]--;
-            moveRight(origId, cost, nodeMap, nodeId, CI, minPtr);
-            origId = nodeId[minPtr];
-        }
-        if (nodeCost < 0)
-            printf("deg = %d, node = %d, nodecost = %d, cost=%d, updates left = %d\n",deg[origId], minPtr, nodeCost, cost[minPtr], updates[origId]);
-
-        isPlaced[origId] = true;
-        //put parents in cache
-        currWinCost += loadParents(minPtr, &G1, &G2, CI, cost, cachePresence, isPlaced, nodeId, nodeMap, revDeg, updates, degThresh, minPtr);
-        minPtr++;
-    }
-    //there is no reordering if only 2 vertices are left
-    //who are already sorted on cost
-    isPlaced[nodeId[G1.numVertex-2]] = true;
-    isPlaced[nodeId[G1.numVertex-1]] = true;
-
-    end = clock();
-
-//    printf("Total time taken for reordering %s is %lf seconds\n", argv[1], (double)(end-start)/CLOCKS_PER_SEC);
-    printf("%s, %lf \n", argv[argc-1], (double)(end-start)/CLOCKS_PER_SEC);
-
-    for (unsigned int i=0; i<G1.numVertex; i++)
-    {
-        if (!isPlaced[i])
-        {
-            printf("ERROR -> failed to place %d\n", i);
-            break;
-        }
-    }
-
-#ifdef DEBUG
-    printf("reordering computed\n");
-#endif
-
   if (maintain && nodeMap[0] != 0) {
-    unsigned int zeros_map = nodeMap[0];
+    V zeros_map = nodeMap[0];
     nodeMap[0] = 0;
     nodeId[0] = 0;
-    for(unsigned int i = 1; i < G2.numVertex; ++i){
+    for(V i = 1; i < G2.numVertex; ++i){
       if (nodeMap[i] == 0) {
         nodeMap[i] = zeros_map;
         nodeId[zeros_map] = i;
@@ -259,56 +198,64 @@ int main(int argc, char** argv)
   }
   
 	dumpNewOrder(&G1, nodeMap, (char *)"newOrder.bin");
+    if (write_original_order("new_order.el", &G1, (const V*) nodeMap) < 0)
+        exit(1);
 
-    //// apply the new order to existing graph
-    //// new reordered graph
-    G2.VI[0] = 0;
-    for (unsigned int i=1; i<G2.numVertex; i++)
+    // .sg / .wsg: permuted and written in one go, no edge list for the converter
+    if (is_serialized_graph(outFile))
     {
-        unsigned int prevNodeId = nodeId[i-1];
-        unsigned int parentStartId = G1.VI[prevNodeId];
-        unsigned int parentEndId = G1.VI[prevNodeId+1];
-        G2.VI[i] = G2.VI[i-1] + (parentEndId - parentStartId);
-        unsigned int tempId = 0;
-        for (unsigned int j=G2.VI[i-1]; j<G2.VI[i]; j++)
-        {
-            G2.EI[j] = nodeMap[G1.EI[parentStartId + tempId]];
-            tempId++;
-        }
+        if (write_serialized_graph(outFile, &G1, &G2, nodeId, nodeMap) < 0)
+            exit(1);
     }
-
-    unsigned int prevNodeId = nodeId[G2.numVertex-1];
-    unsigned int parentStartId = G1.VI[prevNodeId];
-    unsigned int tempId = 0;
-    for (unsigned int i=G2.VI[G2.numVertex-1]; i<G2.numEdges; i++)
+    else
     {
-       G2.EI[i] = nodeMap[G1.EI[parentStartId + tempId]];
-       tempId++;
-    }
+        //// apply the new order to existing graph
+        //// new reordered graph
+        freeMem(&G2);
+        permute_csr(&G1, nodeId, nodeMap, &G2);
 
 #ifdef DEBUG
-    printf("reordering applied\n");
+        printf("reordering applied\n");
 #endif
 
-    // write_csr(argv[argc-1], &G2);
-    write_edge_list(argv[argc-1], &G2, nodeMap);
-    delete[] updates;
+        // write_csr(argv[argc-1], &G2);
+        write_edge_list(outFile, &G2, nodeMap);
+    }
     delete[] nodeId;
-    delete[] cost;
     delete[] nodeMap;
-    delete[] CI;
-    delete[] cachePresence;
-    delete[] isPlaced;
     freeMem(&G1);
     freeMem(&G2);
 
     return 0;
 }
 
-void dumpNewOrder (graph* G, unsigned int* nodeMap, char* fileName)
+// misses of an lru cache of CACHE_SIZE vertices replaying the parent accesses
+// of the partitioned order, against the original order and, with --compare,
+// the sequential pH order
+template <typename V, typename E>
+void reportQuality (graphT<V, E>* G1, graphT<V, E>* G2, V degThresh, V* nodeId)
+{
+    V* identity = new V [G1->numVertex];
+    for (V i=0; i<G1->numVertex; i++)
+        identity[i] = i;
+    unsigned long long origMiss = lruMisses(G1, G2, identity, degThresh, CACHE_SIZE);
+    unsigned long long partMiss = lruMisses(G1, G2, nodeId, degThresh, CACHE_SIZE);
+    printf("lru misses (cache %u): original %llu, partitioned %llu\n", CACHE_SIZE, origMiss, partMiss);
+    if (compareSequential)
+    {
+        phOrder(G1, G2, degThresh, CACHE_SIZE, identity);
+        unsigned long long seqMiss = lruMisses(G1, G2, identity, degThresh, CACHE_SIZE);
+        printf("lru misses (cache %u): sequential %llu, quality loss %+.2lf%%\n", CACHE_SIZE, seqMiss,
+               seqMiss ? 100.0 * ((double) partMiss - (double) seqMiss) / seqMiss : 0.0);
+    }
+    delete[] identity;
+}
+
+template <typename V, typename E>
+void dumpNewOrder (graphT<V, E>* G, V* nodeMap, char* fileName)
 {
 	FILE* fp = fopen(fileName, "wb");
-	fwrite(nodeMap, sizeof(unsigned int), G->numVertex, fp);
+	fwrite(nodeMap, sizeof(V), G->numVertex, fp);
 //	for (int i=0; i<G->numVertex; i++)
 //		fprintf(fp, "%d\n", nodeMap[i]);
 	fclose(fp);
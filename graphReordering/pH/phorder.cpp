@@ -0,0 +1,457 @@
+#include "countingsort.h"
+#include "cachefunc.h"
+#include "phorder.h"
+#include "parallel.h"
+#include "csrfile.h"
+#include <pthread.h>
+
+// sequential pH, nodeId[i] is set to the vertex placed at position i
+template <typename V, typename E>
+void phOrder (graphT<V, E>* G1, graphT<V, E>* G2, V degThresh, unsigned int cacheSize, V* nodeId)
+{
+    //there is no reordering with less than 3 vertices
+    if (G1->numVertex < 3)
+    {
+        for (V i=0; i<G1->numVertex; i++)
+            nodeId[i] = i;
+        return;
+    }
+
+    V* deg = new V [G1->numVertex];
+    for (V i=0; i<G1->numVertex-1; i++)
+        deg[i] = G1->VI[i+1] - G1->VI[i];
+
+    deg[G1->numVertex-1] = G1->numEdges - G1->VI[G1->numVertex-1];
+
+
+    V* revDeg = new V [G1->numVertex];
+    for (V i=0; i<G2->numVertex-1; i++)
+        revDeg[i] = G2->VI[i+1] - G2->VI[i];
+    revDeg[G2->numVertex-1] = G2->numEdges - G2->VI[G2->numVertex-1];
+
+
+
+    //initialize the cost array by degree of each vertex
+    V* cost = new V [G1->numVertex]();
+    V maxCost = 0;
+    for (V i=0; i<G1->numVertex; i++)
+    {
+        E endId = G1->VI[i+1];
+        for (E j=G1->VI[i]; j<endId; j++)
+        {
+            if (revDeg[G1->EI[j]] <= degThresh)
+                cost[i]++;
+        }
+        if (cost[i] > maxCost)
+            maxCost = cost[i];
+    }
+
+    V* updates = new V [G1->numVertex]();
+
+
+    for (V i=0; i<G1->numVertex; i++)
+        nodeId[i] = i;
+
+    parallelSortPairs(cost, nodeId, G1->numVertex);
+
+
+    for (V i=0; i<G1->numVertex; i++)
+        cost[i] = maxCost;
+
+
+
+
+#ifdef DEBUG
+    printf("sorting done\n");
+#endif
+
+
+
+
+    // CI -> array to keep pounsigned inters of start and end positions of a particular value in cost array
+    // eg. cost array = [0, 0, 1, 1, 3, 4, 4, 7]
+    // then CI = [0, 2, 4, 4, 5, 7, 7, 7]
+    // this array will be used in updating cost array in const time so that it always remains sorted
+    V* CI = new V [maxCost+1];
+    V val = 0;
+    CI[0] = 0;
+    V myId = 0;
+    while(val < maxCost)
+    {
+        while(cost[myId] == val)
+            myId++;
+        while(cost[myId] != val)
+            CI[++val] = myId;
+        myId++;
+    }
+
+#ifdef DEBUG
+    printf("cache model created\n");
+#endif
+
+    // nodeMap gives the new position of a vertex in the node array
+    V* nodeMap = new V [G1->numVertex];
+    for (V i=0; i<G1->numVertex; i++)
+        nodeMap[nodeId[i]] = i;
+
+#ifdef DEBUG
+    printf("node mapping computed\n");
+#endif
+
+    //keeps track of number of nodes in cache
+    //if greater than cache size, need to evict
+    V currWinCost = 0;
+    //keeps track of oldest node whose parents
+    //are still in cache
+    V currWinStartId = 0;
+    V* cachePresence = new V [G1->numVertex]();
+
+    //array to tell if a node is already processed
+    //cost of these nodes shouldn't be updated and they
+    //shouldn't be bought back unsigned into processing
+    bool* isPlaced = new bool [G1->numVertex]();
+    //array to store the reordered nodeIds
+    // place the lowest cost node first
+    V minPtr = 0;
+
+
+
+    while(minPtr < G1->numVertex)
+    {
+        if (minPtr >= G1->numVertex-2)
+            break;
+        V origId = nodeId[minPtr];
+        V nodeCost = deg[origId] - (maxCost - cost[minPtr]);
+        while(updates[origId] > 0)
+        {
+            updates[origId]--;
+            moveRight(origId, cost, nodeMap, nodeId, CI, minPtr);
+            origId = nodeId[minPtr];
+        }
+        if (deg[origId] > cacheSize)
+        {
+        //special case, handle separately
+            isPlaced[origId] = true;
+            minPtr++;
+            continue;
+        }
+        while((currWinCost + nodeCost > cacheSize) && (currWinStartId < minPtr-5))
+        {
+            //evict
+            if (deg[nodeId[currWinStartId]] <= cacheSize)
+                currWinCost -= evictParents(currWinStartId, G1, G2, CI, cost, cachePresence, isPlaced, nodeId, nodeMap, revDeg, updates, degThresh);
+            origId = nodeId[minPtr];
+            while(updates[origId] > 0)
+            {
+                updates[origId]--;
+                moveRight(origId, cost, nodeMap, nodeId, CI, minPtr);
+                origId = nodeId[minPtr];
+            }
+            nodeCost = deg[origId] - (maxCost - cost[minPtr]);
+            currWinStartId++;
+            if (deg[origId] > cacheSize)
+            {
+            //special case, handle separately
+                break;
+            }
+        }
+        if (deg[origId] > cacheSize)
+        {
+            isPlaced[origId] = true;
+            minPtr++;
+            continue;
+        }
+        while(updates[origId] > 0)
+        {
+            updates[origId]--;
+            moveRight(origId, cost, nodeMap, nodeId, CI, minPtr);
+            origId = nodeId[minPtr];
+        }
+        if (nodeCost < 0)
+            printf("deg = %d, node = %d, nodecost = %d, cost=%d, updates left = %d\n",deg[origId], minPtr, nodeCost, cost[minPtr], updates[origId]);
+
+        isPlaced[origId] = true;
+        //put parents in cache
+        currWinCost += loadParents(minPtr, G1, G2, CI, cost, cachePresence, isPlaced, nodeId, nodeMap, revDeg, updates, degThresh, minPtr);
+        minPtr++;
+    }
+    //there is no reordering if only 2 vertices are left
+    //who are already sorted on cost
+    isPlaced[nodeId[G1->numVertex-2]] = true;
+    isPlaced[nodeId[G1->numVertex-1]] = true;
+
+    for (V i=0; i<G1->numVertex; i++)
+    {
+        if (!isPlaced[i])
+        {
+            printf("ERROR -> failed to place %d\n", i);
+            break;
+        }
+    }
+
+#ifdef DEBUG
+    printf("reordering computed\n");
+#endif
+
+    delete[] deg;
+    delete[] revDeg;
+    delete[] updates;
+    delete[] cost;
+    delete[] nodeMap;
+    delete[] CI;
+    delete[] cachePresence;
+    delete[] isPlaced;
+}
+
+// coarse bfs over the undirected graph, numParts slices of the bfs order
+// with about the same number of edges each. every slice is reordered with
+// phOrder on its induced subgraph (edges between slices are dropped), the
+// slices run in parallel and their orders are concatenated
+template <typename V, typename E>
+void phOrderPartitioned (graphT<V, E>* G1, graphT<V, E>* G2, V degThresh, unsigned int cacheSize, unsigned int numParts, V* nodeId)
+{
+    V numVertex = G1->numVertex;
+    V* bfsOrder = new V [numVertex];
+    bool* visited = new bool [numVertex]();
+    V head = 0, tail = 0;
+    for (V root=0; root<numVertex; root++)
+    {
+        if (visited[root])
+            continue;
+        visited[root] = true;
+        bfsOrder[tail++] = root;
+        while (head < tail)
+        {
+            V u = bfsOrder[head++];
+            graphT<V, E>* dir[2] = {G1, G2};
+            for (unsigned int g=0; g<2; g++)
+            {
+                for (E j=dir[g]->VI[u]; j<dir[g]->VI[u+1]; j++)
+                {
+                    V v = dir[g]->EI[j];
+                    if (!visited[v])
+                    {
+                        visited[v] = true;
+                        bfsOrder[tail++] = v;
+                    }
+                }
+            }
+        }
+    }
+    delete[] visited;
+
+    // cut the bfs order so every part holds about the same number of edges
+    V* partStart = new V [numParts+1];
+    unsigned long long total = (unsigned long long) G1->numEdges + numVertex;
+    unsigned long long acc = 0;
+    unsigned int p = 0;
+    partStart[0] = 0;
+    for (V i=0; i<numVertex && p+1<numParts; i++)
+    {
+        V u = bfsOrder[i];
+        acc += G1->VI[u+1] - G1->VI[u] + 1;
+        if (acc >= total * (p+1) / numParts)
+            partStart[++p] = i+1;
+    }
+    while (p < numParts)
+        partStart[++p] = numVertex;
+
+    unsigned int* part = new unsigned int [numVertex];
+    V* localId = new V [numVertex];
+    for (p=0; p<numParts; p++)
+    {
+        for (V i=partStart[p]; i<partStart[p+1]; i++)
+        {
+            part[bfsOrder[i]] = p;
+            localId[bfsOrder[i]] = i - partStart[p];
+        }
+    }
+
+    parallelFor(numParts, [&](unsigned int tid, unsigned long long first, unsigned long long last) {
+        for (unsigned long long q=first; q<last; q++)
+        {
+            V base = partStart[q];
+            V n = partStart[q+1] - base;
+            if (n == 0)
+                continue;
+            // subgraph induced by the part, in local ids
+            graphT<V, E> sub1, sub2;
+            sub1.numVertex = n;
+            sub1.VI = new E [n+1];
+            sub1.VI[0] = 0;
+            for (V i=0; i<n; i++)
+            {
+                V u = bfsOrder[base+i];
+                E cnt = 0;
+                for (E j=G1->VI[u]; j<G1->VI[u+1]; j++)
+                    cnt += (part[G1->EI[j]] == q);
+                sub1.VI[i+1] = sub1.VI[i] + cnt;
+            }
+            sub1.numEdges = sub1.VI[n];
+            sub1.EI = new V [sub1.numEdges > 0 ? sub1.numEdges : 1];
+            for (V i=0; i<n; i++)
+            {
+                V u = bfsOrder[base+i];
+                E pos = sub1.VI[i];
+                for (E j=G1->VI[u]; j<G1->VI[u+1]; j++)
+                {
+                    if (part[G1->EI[j]] == q)
+                        sub1.EI[pos++] = localId[G1->EI[j]];
+                }
+            }
+            createReverseCSR(&sub1, &sub2, n);
+
+            V* localOrder = new V [n];
+            phOrder(&sub1, &sub2, degThresh, cacheSize, localOrder);
+            for (V i=0; i<n; i++)
+                nodeId[base+i] = bfsOrder[base + localOrder[i]];
+
+            delete[] localOrder;
+            freeMem(&sub1);
+            freeMem(&sub2);
+        }
+    });
+
+    unsigned long long cut = 0;
+    for (V u=0; u<numVertex; u++)
+    {
+        for (E j=G1->VI[u]; j<G1->VI[u+1]; j++)
+            cut += (part[G1->EI[j]] != part[u]);
+    }
+    printf("partitioned pH: %u parts, %.2lf%% of edges cut\n", numParts, G1->numEdges ? 100.0 * cut / G1->numEdges : 0.0);
+
+    delete[] bfsOrder;
+    delete[] partStart;
+    delete[] part;
+    delete[] localId;
+}
+
+// bytes a window needs per vertex of out-degree deg: its mapped row for this and the
+// prefetched next window, the induced subgraph and its reverse, and the arrays of phOrder
+template <typename V, typename E>
+static unsigned long long windowBytes (E deg)
+{
+    return 4 * (sizeof(E) + deg * sizeof(V)) + 10 * sizeof(V) + 1;
+}
+
+// rows [first, last) of G as they sit in the mapping
+template <typename V, typename E>
+struct windowRange
+{
+    graphT<V, E>* G;
+    V first, last;
+};
+
+template <typename V, typename E>
+static void* prefetchWindow (void* arg)
+{
+    windowRange<V, E>* w = (windowRange<V, E>*) arg;
+    bcsr_prefetch(w->G->VI + w->first, (w->last - w->first + 1) * sizeof(E));
+    bcsr_prefetch(w->G->EI + w->G->VI[w->first], (w->G->VI[w->last] - w->G->VI[w->first]) * sizeof(V));
+    return NULL;
+}
+
+template <typename V, typename E>
+void phOrderStreaming (graphT<V, E>* G1, V degThresh, unsigned int cacheSize, unsigned long long budget, V* nodeId)
+{
+    V numVertex = G1->numVertex;
+    bool mapped = (G1->file != NULL);
+
+    // cut the ids into windows that fit the budget, the offsets of a window are
+    // dropped again once it is cut so the pass holds one window of them at a time
+    vector<V> windowStart(1, 0);
+    unsigned long long acc = 0;
+    for (V u=0; u<numVertex; u++)
+    {
+        unsigned long long bytes = windowBytes<V, E>(G1->VI[u+1] - G1->VI[u]);
+        if (acc + bytes > budget && u > windowStart.back())
+        {
+            if (mapped)
+                bcsr_release(G1->VI + windowStart.back(), (u - windowStart.back()) * sizeof(E));
+            windowStart.push_back(u);
+            acc = 0;
+        }
+        acc += bytes;
+    }
+    if (mapped)
+        bcsr_release(G1->VI + windowStart.back(), (numVertex - windowStart.back() + 1) * sizeof(E));
+    windowStart.push_back(numVertex);
+    size_t numWindows = windowStart.size() - 1;
+    printf("out-of-core pH: %llu windows for a budget of %llu kB\n", (unsigned long long) numWindows, budget >> 10);
+
+    windowRange<V, E> next;
+    pthread_t prefetcher;
+    bool prefetching = false;
+    if (mapped && numWindows > 0)
+    {
+        windowRange<V, E> cur = {G1, windowStart[0], windowStart[1]};
+        prefetchWindow<V, E>(&cur);
+    }
+    for (size_t w=0; w<numWindows; w++)
+    {
+        V base = windowStart[w];
+        V n = windowStart[w+1] - base;
+
+        // the next window is read in while this one is ordered
+        if (mapped && w+1 < numWindows)
+        {
+            next.G = G1;
+            next.first = windowStart[w+1];
+            next.last = windowStart[w+2];
+            prefetching = (pthread_create(&prefetcher, NULL, prefetchWindow<V, E>, (void*) &next) == 0);
+        }
+
+        // subgraph induced by the window, in local ids
+        graphT<V, E> sub1, sub2;
+        sub1.numVertex = n;
+        sub1.VI = new E [n+1];
+        sub1.VI[0] = 0;
+        for (V i=0; i<n; i++)
+        {
+            E cnt = 0;
+            for (E j=G1->VI[base+i]; j<G1->VI[base+i+1]; j++)
+                cnt += (G1->EI[j] >= base && G1->EI[j] - base < n);
+            sub1.VI[i+1] = sub1.VI[i] + cnt;
+        }
+        sub1.numEdges = sub1.VI[n];
+        sub1.EI = new V [sub1.numEdges > 0 ? sub1.numEdges : 1];
+        for (V i=0; i<n; i++)
+        {
+            E pos = sub1.VI[i];
+            for (E j=G1->VI[base+i]; j<G1->VI[base+i+1]; j++)
+            {
+                if (G1->EI[j] >= base && G1->EI[j] - base < n)
+                    sub1.EI[pos++] = G1->EI[j] - base;
+            }
+        }
+        createReverseCSR(&sub1, &sub2, n);
+
+        V* localOrder = new V [n];
+        phOrder(&sub1, &sub2, degThresh, cacheSize, localOrder);
+        for (V i=0; i<n; i++)
+            nodeId[base+i] = base + localOrder[i];
+
+        delete[] localOrder;
+        freeMem(&sub1);
+        freeMem(&sub2);
+
+        if (prefetching)
+        {
+            pthread_join(prefetcher, NULL);
+            prefetching = false;
+        }
+        if (mapped)
+        {
+            bcsr_release(G1->VI + base, (n + 1) * sizeof(E));
+            bcsr_release(G1->EI + G1->VI[base], (G1->VI[base+n] - G1->VI[base]) * sizeof(V));
+        }
+    }
+}
+
+#define INSTANTIATE_PHORDER(V, E) \
+    template void phOrder (graphT<V, E>*, graphT<V, E>*, V, unsigned int, V*); \
+    template void phOrderPartitioned (graphT<V, E>*, graphT<V, E>*, V, unsigned int, unsigned int, V*); \
+    template void phOrderStreaming (graphT<V, E>*, V, unsigned int, unsigned long long, V*);
+
+INSTANTIATE_PHORDER(unsigned int, unsigned int)
+INSTANTIATE_PHORDER(unsigned int, unsigned long long)
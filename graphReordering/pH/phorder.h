@@ -0,0 +1,26 @@
+#ifndef PHORDER_HEADER_INCL
+#define PHORDER_HEADER_INCL
+
+#include "graph.h"
+
+// G1 is the csr, G2 its reverse. nodeId[i] is set to the vertex placed at
+// position i, parents with more than degThresh children are not cached and
+// vertices with more than cacheSize parents are placed without the cache model
+template <typename V, typename E>
+void phOrder (graphT<V, E>*, graphT<V, E>*, V, unsigned int, V*);
+
+// phOrder on numParts slices of a bfs order, in parallel
+template <typename V, typename E>
+void phOrderPartitioned (graphT<V, E>*, graphT<V, E>*, V, unsigned int, unsigned int, V*);
+
+// out-of-core phOrder: the ids are cut into windows (vertex ranges) whose rows and
+// working set fit in budget bytes, every window is ordered with phOrder on its
+// induced subgraph (edges between windows are dropped). with a .bcsr input the
+// rows stay in the mapping, the next window is prefetched while the current one
+// is ordered and released once it is done. budget only covers the windows, the
+// caller keeps nodeId and anything else of O(numVertex) outside it.
+// G1 must not have been modified in place
+template <typename V, typename E>
+void phOrderStreaming (graphT<V, E>*, V, unsigned int, unsigned long long, V*);
+
+#endif
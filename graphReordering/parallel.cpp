@@ -0,0 +1,10 @@
+#include "parallel.h"
+#include <unistd.h>
+
+unsigned int defaultNumThreads ()
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return (cores > 0) ? (unsigned int)cores : 1;
+}
+
+unsigned int numThreads = defaultNumThreads();
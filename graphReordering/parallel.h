@@ -0,0 +1,127 @@
+#ifndef PARALLEL_HEADER_INCL
+#define PARALLEL_HEADER_INCL
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+// number of worker threads used by the parallel stages
+// defaults to the number of online cores, overridden with -t
+extern unsigned int numThreads;
+
+unsigned int defaultNumThreads ();
+
+template <typename F>
+struct threadTask
+{
+    unsigned int tid;
+    unsigned long long start;
+    unsigned long long end;
+    F* body;
+};
+
+template <typename F>
+void* runThreadTask (void* arg)
+{
+    threadTask<F>* task = (threadTask<F>*) arg;
+    (*task->body)(task->tid, task->start, task->end);
+    return NULL;
+}
+
+// split [0, n) into T contiguous ranges and call
+// body(tid, start, end) on each of them, thread 0 runs on the caller
+template <typename F>
+void parallelFor (unsigned long long n, unsigned int T, F body)
+{
+    if (T == 0)
+        T = 1;
+    if (n < T)
+        T = (n == 0) ? 1 : (unsigned int)n;
+
+    threadTask<F>* tasks = new threadTask<F> [T];
+    pthread_t* threads = new pthread_t [T];
+    for (unsigned int t=0; t<T; t++)
+    {
+        tasks[t].tid = t;
+        tasks[t].start = (n * t) / T;
+        tasks[t].end = (n * (t+1)) / T;
+        tasks[t].body = &body;
+    }
+    for (unsigned int t=1; t<T; t++)
+    {
+        if (pthread_create(&threads[t], NULL, runThreadTask<F>, (void*) &tasks[t]) != 0)
+        {
+            fputs("failed to create thread\n", stderr);
+            exit(1);
+        }
+    }
+    runThreadTask<F>((void*) &tasks[0]);
+    for (unsigned int t=1; t<T; t++)
+        pthread_join(threads[t], NULL);
+
+    delete[] threads;
+    delete[] tasks;
+}
+
+// same with numThreads ranges
+template <typename F>
+void parallelFor (unsigned long long n, F body)
+{
+    parallelFor(n, numThreads, body);
+}
+
+// exclusive prefix sum of arr[0, n) written to out[0, n], out[n] holds the total
+// arr and out may not alias
+template <typename V, typename S>
+void parallelPrefixSum (const V* arr, S* out, unsigned long long n)
+{
+    unsigned int T = (numThreads == 0) ? 1 : numThreads;
+    S* partial = new S [T + 1]();
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        S sum = 0;
+        for (unsigned long long i=start; i<end; i++)
+            sum += arr[i];
+        partial[tid+1] = sum;
+    });
+    for (unsigned int t=1; t<=T; t++)
+        partial[t] += partial[t-1];
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        S sum = partial[tid];
+        for (unsigned long long i=start; i<end; i++)
+        {
+            out[i] = sum;
+            sum += arr[i];
+        }
+    });
+    out[n] = partial[T];
+    delete[] partial;
+}
+
+// appends val(i) for every i in [0, n) with keep(i) to out, in order of i,
+// returns the number of values written
+template <typename V, typename P, typename F>
+V parallelPack (unsigned long long n, P keep, F val, V* out)
+{
+    unsigned int T = (numThreads == 0) ? 1 : numThreads;
+    V* count = new V [T + 1]();
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        V c = 0;
+        for (unsigned long long i=start; i<end; i++)
+            if (keep(i))
+                c++;
+        count[tid+1] = c;
+    });
+    for (unsigned int t=1; t<=T; t++)
+        count[t] += count[t-1];
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        V pos = count[tid];
+        for (unsigned long long i=start; i<end; i++)
+            if (keep(i))
+                out[pos++] = val(i);
+    });
+    V total = count[T];
+    delete[] count;
+    return total;
+}
+
+#endif
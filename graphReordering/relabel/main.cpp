@@ -0,0 +1,96 @@
+#include <iostream>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "parallel.h"
+#ifndef GRAPH_HEADER_INCL
+#include "graph.h"
+#endif
+
+using namespace std;
+
+bool weighted = false, maintain = false, indegree = false;
+
+template <typename V, typename E>
+int relabel (char*, char*, char*);
+
+int main(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        printf("Usage : %s <--maintain(optional)> <--weighted(optional)> <--threads n(optional)> <orderFile or -> <inputFile1> <outputFile>\n", argv[0]);
+        exit(1);
+    }
+    for (int i = 1; i < argc-3; i++){
+      char * opt = argv[i];
+      if (strcmp(opt, "-m") == 0 || strcmp(opt,"--maintain") == 0) maintain = true;
+      else if (strcmp(opt, "-w") == 0 || strcmp(opt,"--weighted") == 0) weighted = true;
+      else if ((strcmp(opt, "-t") == 0 || strcmp(opt,"--threads") == 0) && i+1 < argc-3) numThreads = atoi(argv[++i]);
+    }
+
+    return relabel<unsigned int, unsigned long long>(argv[argc-3], argv[argc-2], argv[argc-1]);
+}
+
+template <typename V, typename E>
+int relabel (char* orderFile, char* inFile, char* outFile)
+{
+    vector<V> order;
+    // one new id per line, as in new_order.el or the output of rabbit order
+    if (read_new_order(orderFile, order) < 0)
+        exit(1);
+
+    V* src;
+    V* dst;
+    unsigned int* weights;
+    E numEdges;
+    V numVertex;
+    if (read_edge_list(inFile, src, dst, weights, numEdges, numVertex) < 0)
+        exit(1);
+
+    printf("file reading done. Num vertices = %d and numEdges = %llu, order has %llu entries\n", numVertex, (unsigned long long) numEdges, (unsigned long long) order.size());
+
+    struct timeval start, end;
+    gettimeofday(&start, NULL);
+
+    // ids past the end of the order keep their id
+    V n = max((V) order.size(), numVertex);
+    V* newId = new V [n];
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long v=start; v<end; v++)
+            newId[v] = (v < order.size()) ? order[v] : v;
+    });
+
+    // swap vertex 0 with the vertex that was given id 0
+    if (maintain && newId[0] != 0)
+    {
+        for (V i=1; i<n; i++)
+        {
+            if (newId[i] == 0)
+            {
+                newId[i] = newId[0];
+                break;
+            }
+        }
+        newId[0] = 0;
+    }
+
+    if (is_serialized_graph(outFile))
+    {
+        if (write_relabeled_serialized_graph(outFile, src, dst, weights, numEdges, n, (const V*) newId) < 0)
+            exit(1);
+    }
+    else if (write_relabeled_edge_list(outFile, src, dst, weights, numEdges, (const V*) newId) < 0)
+        exit(1);
+    gettimeofday(&end, NULL);
+
+    printf("%s, %lf \n", outFile, (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec)/1e6);
+
+    delete[] newId;
+    delete[] src;
+    delete[] dst;
+    delete[] weights;
+
+    return 0;
+}
@@ -0,0 +1,309 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "parallel.h"
+#include "countingsort.h"
+#ifndef GRAPH_HEADER_INCL
+#include "graph.h"
+#endif
+
+using namespace std;
+
+bool weighted = false, maintain = false, indegree = false;
+
+// scratchpad per core and cores, as gem5_run_acc.sh: 16 x 1MB
+unsigned long long spmSize = 1 << 20;
+unsigned int cores = 16;
+// bytes per vertex of every array the app maps, summed (8: one double, as pagerank)
+vector<unsigned long long> propSizes;
+// with an output file: write the hot-first variant of the (first) order
+char* hotFirstFile = NULL;
+
+template <typename V, typename E>
+int plan (char*, vector<char*>&);
+
+// "1M" -> 1048576, as the --caches of cachesim
+static bool parseSize (const char* s, unsigned long long& size)
+{
+    char* end;
+    size = strtoull(s, &end, 10);
+    if (end == s)
+        return false;
+    if (*end == 'K' || *end == 'k') { size <<= 10; end++; }
+    else if (*end == 'M' || *end == 'm') { size <<= 20; end++; }
+    else if (*end == 'G' || *end == 'g') { size <<= 30; end++; }
+    return *end == '\0';
+}
+
+// "8,4" -> 8 4
+static bool parseProps (const char* list, vector<unsigned long long>& sizes)
+{
+    const char* p = list;
+    while (*p != '\0')
+    {
+        char* end;
+        unsigned long long size = strtoull(p, &end, 10);
+        if (end == p || size == 0)
+            return false;
+        sizes.push_back(size);
+        if (*end == ',')
+            end++;
+        else if (*end != '\0')
+            return false;
+        p = end;
+    }
+    return !sizes.empty();
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage : %s <--spm bytes(optional)> <--cores n(optional)> <--props 8,4,..(optional)> <--indegree(optional)> <--hot-first outputFile(optional)> <--maintain(optional)> <--weighted(optional)> <--threads n(optional)> <inputFile1> <orderFile ...(optional)>\n", argv[0]);
+        exit(1);
+    }
+    int i = 1;
+    for (; i < argc-1; i++){
+      char * opt = argv[i];
+      if (strcmp(opt, "-m") == 0 || strcmp(opt,"--maintain") == 0) maintain = true;
+      else if (strcmp(opt, "-i") == 0 || strcmp(opt,"--indegree") == 0) indegree = true;
+      else if (strcmp(opt, "-w") == 0 || strcmp(opt,"--weighted") == 0) weighted = true;
+      else if (strcmp(opt, "--spm") == 0 && i+1 < argc-1)
+      {
+          if (!parseSize(argv[++i], spmSize))
+          {
+              fprintf(stderr, "bad spm size %s, expected e.g. 1M\n", argv[i]);
+              exit(1);
+          }
+      }
+      else if (strcmp(opt, "--cores") == 0 && i+1 < argc-1) cores = atoi(argv[++i]);
+      else if (strcmp(opt, "--props") == 0 && i+1 < argc-1)
+      {
+          if (!parseProps(argv[++i], propSizes))
+          {
+              fprintf(stderr, "bad property sizes %s, expected e.g. 8,4\n", argv[i]);
+              exit(1);
+          }
+      }
+      else if (strcmp(opt, "--hot-first") == 0 && i+1 < argc-1) hotFirstFile = argv[++i];
+      else if ((strcmp(opt, "-t") == 0 || strcmp(opt,"--threads") == 0) && i+1 < argc-1) numThreads = atoi(argv[++i]);
+      else break;
+    }
+    if (propSizes.empty())
+        propSizes.push_back(8);
+
+    char* inFile = argv[i];
+    vector<char*> orders(argv + i + 1, argv + argc);
+    if (hotFirstFile != NULL && orders.size() > 1)
+    {
+        fputs("--hot-first takes at most one orderFile\n", stderr);
+        exit(1);
+    }
+
+    // ids are not compacted, as in relabel the order lines are the input ids
+    return plan<unsigned int, unsigned long long>(inFile, orders);
+}
+
+struct spmHits
+{
+    // edges whose source / destination id is below the mapped count
+    unsigned long long src = 0, dst = 0;
+};
+
+// OMEGA maps the ids [0, spmVertices), an endpoint hits when its new id is below that
+template <typename V, typename E>
+static spmHits countHits (V* src, V* dst, E numEdges, const V* newId, V spmVertices)
+{
+    unsigned int T = (numThreads == 0) ? 1 : numThreads;
+    vector<spmHits> partial(T);
+    parallelFor(numEdges, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        spmHits h;
+        for (unsigned long long j=start; j<end; j++)
+        {
+            if (newId[src[j]] < spmVertices)
+                h.src++;
+            if (newId[dst[j]] < spmVertices)
+                h.dst++;
+        }
+        partial[tid] = h;
+    });
+    spmHits H;
+    for (unsigned int t=0; t<T; t++)
+    {
+        H.src += partial[t].src;
+        H.dst += partial[t].dst;
+    }
+    return H;
+}
+
+template <typename E>
+static void printHits (const char* name, spmHits H, E numEdges, double seconds)
+{
+    double m = (numEdges == 0) ? 1 : (double) numEdges;
+    printf("%s, %lf, %lf, %lf, %lf\n", name, (H.src + H.dst) / (2 * m), H.dst / m, H.src / m, seconds);
+}
+
+// newId of an order file over the input ids, false unless it is a permutation of [0, n)
+template <typename V>
+static bool readOrder (char* orderFile, V n, V* newId)
+{
+    vector<V> order;
+    if (read_new_order(orderFile, order) < 0)
+        exit(1);
+    // one line per input id, a shorter order is not padded
+    if (order.size() != n)
+        return false;
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long v=start; v<end; v++)
+            newId[v] = order[v];
+    });
+    vector<unsigned char> seen(n, 0);
+    for (V v=0; v<n; v++)
+    {
+        if (newId[v] >= n || seen[newId[v]])
+            return false;
+        seen[newId[v]] = 1;
+    }
+    return true;
+}
+
+// hot-first variant of newId: the spmVertices vertices with the most accesses move to the
+// front, the hot and the cold vertices each keep the order they had (ph, br, ...), ties at
+// the boundary go to the vertex that came first
+template <typename V>
+static void hotFirst (const V* newId, V n, const V* degree, V spmVertices, V* hotId)
+{
+    V* order = new V [n];
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long v=start; v<end; v++)
+            order[newId[v]] = v;
+    });
+    V* byDegree = new V [n];
+    memcpy(byDegree, order, (size_t) n * sizeof(V));
+    parallelCountingSortBy(byDegree, n, degree, true);
+    vector<unsigned char> hot(n, 0);
+    parallelFor(spmVertices, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long r=start; r<end; r++)
+            hot[byDegree[r]] = 1;
+    });
+
+    V* hotOrder = byDegree;
+    V numHot = parallelPack(n, [&](unsigned long long p) { return hot[order[p]] != 0; },
+                            [&](unsigned long long p) { return order[p]; }, hotOrder);
+    parallelPack(n, [&](unsigned long long p) { return hot[order[p]] == 0; },
+                 [&](unsigned long long p) { return order[p]; }, hotOrder + numHot);
+    if (maintain)
+    {
+        V p = 0;
+        while (hotOrder[p] != 0)
+            p++;
+        memmove(hotOrder + 1, hotOrder, p * sizeof(V));
+        hotOrder[0] = 0;
+    }
+    parallelFor(n, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long r=start; r<end; r++)
+            hotId[hotOrder[r]] = r;
+    });
+    delete[] order;
+    delete[] byDegree;
+}
+
+template <typename V, typename E>
+int plan (char* inFile, vector<char*>& orderFiles)
+{
+    V* src;
+    V* dst;
+    unsigned int* weights;
+    E numEdges;
+    V numVertex;
+
+    if (read_edge_list(inFile, src, dst, weights, numEdges, numVertex) < 0)
+        exit(1);
+
+    printf("file reading done. Num vertices = %d and numEdges = %llu\n", numVertex, (unsigned long long) numEdges);
+
+    // the mapped prefix, every mapped array takes its property of a vertex
+    unsigned long long vertexBytes = 0;
+    for (size_t p=0; p<propSizes.size(); p++)
+        vertexBytes += propSizes[p];
+    unsigned long long capacity = (unsigned long long) cores * spmSize / vertexBytes;
+    V spmVertices = (V) min(capacity, (unsigned long long) numVertex);
+    printf("spm holds %u of %u vertices (%u x %llu bytes, %llu bytes per vertex)\n", spmVertices, numVertex, cores, spmSize, vertexBytes);
+
+    // accesses per vertex: the edges it is an endpoint of, only the in-edges with
+    // --indegree (the writeX / cas32 of the push apps go to the destination)
+    V* degree = new V [numVertex];
+    parallelFor(numVertex, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long v=start; v<end; v++)
+            degree[v] = 0;
+    });
+    parallelFor(numEdges, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long j=start; j<end; j++)
+        {
+            __sync_fetch_and_add(&degree[dst[j]], 1);
+            if (!indegree)
+                __sync_fetch_and_add(&degree[src[j]], 1);
+        }
+    });
+
+    printf("order, endpoint hit ratio, dst hit ratio, src hit ratio, time\n");
+
+    V* newId = new V [numVertex];
+    V* hotId = new V [numVertex];
+    if (orderFiles.empty())
+        orderFiles.push_back(NULL);
+    for (size_t f=0; f<orderFiles.size(); f++)
+    {
+        struct timeval start, end;
+        gettimeofday(&start, NULL);
+        if (orderFiles[f] == NULL)
+        {
+            parallelFor(numVertex, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+                for (unsigned long long v=start; v<end; v++)
+                    newId[v] = v;
+            });
+        }
+        else if (!readOrder(orderFiles[f], numVertex, newId))
+        {
+            fprintf(stderr, "%s is not an order of the %u vertices of %s\n", orderFiles[f], numVertex, inFile);
+            exit(1);
+        }
+        spmHits H = countHits(src, dst, numEdges, newId, spmVertices);
+        gettimeofday(&end, NULL);
+        string name = (orderFiles[f] != NULL) ? orderFiles[f] : inFile;
+        printHits(name.c_str(), H, numEdges, (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec)/1e6);
+
+        gettimeofday(&start, NULL);
+        hotFirst(newId, numVertex, degree, spmVertices, hotId);
+        H = countHits(src, dst, numEdges, hotId, spmVertices);
+        gettimeofday(&end, NULL);
+        printHits((name + " hot-first").c_str(), H, numEdges, (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec)/1e6);
+    }
+
+    if (hotFirstFile != NULL)
+    {
+        if (write_new_order("new_order.el", hotId, numVertex) < 0)
+            exit(1);
+        if (is_serialized_graph(hotFirstFile))
+        {
+            if (write_relabeled_serialized_graph(hotFirstFile, src, dst, weights, numEdges, numVertex, (const V*) hotId) < 0)
+                exit(1);
+        }
+        else if (write_relabeled_edge_list(hotFirstFile, src, dst, weights, numEdges, hotId) < 0)
+            exit(1);
+    }
+
+    delete[] degree;
+    delete[] newId;
+    delete[] hotId;
+    delete[] src;
+    delete[] dst;
+    delete[] weights;
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#ifndef TRANSPOSE_HEADER_INCL
+#define TRANSPOSE_HEADER_INCL
+
+#include "parallel.h"
+
+// parallel transpose of a csr with n rows and column ids in [0, m)
+// row u holds ei[rowStart(u), rowStart(u+1)), rowStart(n) is the number of edges
+// tvi gets the m+1 offsets of the transpose, tei its lists and tw the weights
+// moved along with their edges (only when w is given)
+// the rows are split into chunks with about the same number of edges, every chunk
+// histograms its own columns and one pass over (column, chunk) turns the histograms
+// into write offsets, so the scatter needs no atomics. chunks write in row order,
+// so every transposed list comes out sorted by row id
+template <typename V, typename E, typename R, typename W = unsigned int>
+void parallelTranspose (V n, R rowStart, const V* ei, V m, E* tvi, V* tei, const W* w = NULL, W* tw = NULL)
+{
+    unsigned long long numEdges = rowStart(n);
+    // keep the histograms smaller than the edges they count
+    unsigned long long numChunks = (m == 0) ? 1 : numEdges / m;
+    if (numChunks > numThreads)
+        numChunks = numThreads;
+    if (numChunks == 0)
+        numChunks = 1;
+
+    // chunk c covers rows [firstRow[c], firstRow[c+1])
+    V* firstRow = new V [numChunks+1];
+    for (unsigned long long c=0; c<=numChunks; c++)
+    {
+        unsigned long long target = (numEdges * c) / numChunks;
+        V lo = 0, hi = n;
+        while (lo < hi)
+        {
+            V mid = lo + (hi - lo) / 2;
+            if ((unsigned long long) rowStart(mid) < target)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        firstRow[c] = (c == numChunks) ? n : lo;
+    }
+
+    E* hist = new E [numChunks * m]();
+    parallelFor(numChunks, numChunks, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        E* h = hist + tid * (unsigned long long) m;
+        for (V u=firstRow[tid]; u<firstRow[tid+1]; u++)
+            for (E j=rowStart(u); j<rowStart(u+1); j++)
+                h[ei[j]]++;
+    });
+
+    E* colSize = new E [m];
+    parallelFor(m, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long v=start; v<end; v++)
+        {
+            E sum = 0;
+            for (unsigned long long c=0; c<numChunks; c++)
+                sum += hist[c * m + v];
+            colSize[v] = sum;
+        }
+    });
+    parallelPrefixSum(colSize, tvi, m);
+    parallelFor(m, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        for (unsigned long long v=start; v<end; v++)
+        {
+            E offset = tvi[v];
+            for (unsigned long long c=0; c<numChunks; c++)
+            {
+                E cnt = hist[c * m + v];
+                hist[c * m + v] = offset;
+                offset += cnt;
+            }
+        }
+    });
+
+    parallelFor(numChunks, numChunks, [&](unsigned int tid, unsigned long long start, unsigned long long end) {
+        E* h = hist + tid * (unsigned long long) m;
+        for (V u=firstRow[tid]; u<firstRow[tid+1]; u++)
+        {
+            for (E j=rowStart(u); j<rowStart(u+1); j++)
+            {
+                E pos = h[ei[j]]++;
+                tei[pos] = u;
+                if (w != NULL)
+                    tw[pos] = w[j];
+            }
+        }
+    });
+
+    delete[] firstRow;
+    delete[] hist;
+    delete[] colSize;
+}
+
+#endif
@@ -0,0 +1,270 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include "stats.h"
+
+using namespace std;
+
+// runs the graphit apps built by compile_runner.sh (<appPath>/<single|multi>/<pull|push>/<app>)
+// on every graph. each binary loads its graph once and does warmup + trials runs of its
+// main loop (see logger.cpp), the runtimes of the trials come back through $GRAPHIT_PERF_OUT
+
+unsigned int trials = 10, warmup = 2;
+const char* outFile = "statistics.json";
+const char* perfDir = "perf";
+vector<string> directions, threads;
+vector<int> cpus;
+
+static vector<string> splitList (const char* s)
+{
+    vector<string> list;
+    string cur;
+    for (const char* p = s; ; p++)
+    {
+        if (*p == ',' || *p == '\0')
+        {
+            if (!cur.empty())
+                list.push_back(cur);
+            cur.clear();
+            if (*p == '\0')
+                break;
+        }
+        else
+            cur += *p;
+    }
+    return list;
+}
+
+// "0-3,8" -> 0 1 2 3 8
+static vector<int> parseCpus (const char* s)
+{
+    vector<int> list;
+    vector<string> ranges = splitList(s);
+    for (size_t i=0; i<ranges.size(); i++)
+    {
+        int a, b;
+        int k = sscanf(ranges[i].c_str(), "%d-%d", &a, &b);
+        if (k < 1)
+        {
+            fprintf(stderr, "bad cpu list %s\n", s);
+            exit(1);
+        }
+        if (k == 1)
+            b = a;
+        for (int c=a; c<=b; c++)
+            list.push_back(c);
+    }
+    return list;
+}
+
+// the runtimes in the last line of a perf file written by logger.cpp
+static vector<double> readRuns (const char* file)
+{
+    vector<double> runs;
+    FILE* fp = fopen(file, "r");
+    if (fp == NULL)
+        return runs;
+    string line, last;
+    int ch;
+    while ((ch = fgetc(fp)) != EOF)
+    {
+        if (ch == '\n')
+        {
+            if (!line.empty())
+                last = line;
+            line.clear();
+        }
+        else
+            line += (char) ch;
+    }
+    if (!line.empty())
+        last = line;
+    fclose(fp);
+
+    size_t pos = last.find("\"runs\": [");
+    if (pos == string::npos)
+        return runs;
+    const char* p = last.c_str() + pos + 9;
+    while (*p != ']' && *p != '\0')
+    {
+        char* end;
+        double v = strtod(p, &end);
+        if (end == p)
+            break;
+        runs.push_back(v);
+        p = end;
+        while (*p == ',' || *p == ' ')
+            p++;
+    }
+    return runs;
+}
+
+// runs binary on graph pinned to the cpus, single threaded on the first one,
+// returns false when it could not run or failed
+static bool runApp (const string& binary, const string& graph, bool multi, const string& perfFile)
+{
+    pid_t pid = fork();
+    if (pid < 0)
+        return false;
+    if (pid == 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (size_t i=0; i<(multi ? cpus.size() : 1); i++)
+            CPU_SET(cpus[i], &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0)
+            perror("sched_setaffinity");
+
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%zu", multi ? cpus.size() : (size_t) 1);
+        setenv("OMP_NUM_THREADS", buf, 1);
+        setenv("OMP_PROC_BIND", "close", 1);
+        setenv("OMP_PLACES", "threads", 1);
+        snprintf(buf, sizeof(buf), "%u", trials);
+        setenv("GRAPHIT_TRIALS", buf, 1);
+        snprintf(buf, sizeof(buf), "%u", warmup);
+        setenv("GRAPHIT_WARMUP", buf, 1);
+        setenv("GRAPHIT_PERF_OUT", perfFile.c_str(), 1);
+
+        // the apps print every runtime
+        int null = open("/dev/null", O_WRONLY);
+        if (null >= 0)
+            dup2(null, STDOUT_FILENO);
+        execl(binary.c_str(), binary.c_str(), graph.c_str(), (char*) NULL);
+        _exit(127);
+    }
+    int status;
+    if (waitpid(pid, &status, 0) < 0)
+        return false;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static string baseName (const string& path)
+{
+    size_t slash = path.rfind('/');
+    string name = (slash == string::npos) ? path : path.substr(slash + 1);
+    size_t dot = name.rfind('.');
+    return (dot == string::npos || dot == 0) ? name : name.substr(0, dot);
+}
+
+static bool isWeighted (const string& path)
+{
+    size_t dot = path.rfind('.');
+    return dot != string::npos && (path.substr(dot) == ".wel" || path.substr(dot) == ".wsg");
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("Usage : %s <--trials n(optional)> <--warmup n(optional)> <--cpus 0-7(optional)> <--apps pagerank,cc,..(optional)> <--directions pull,push(optional)> <--threads single,multi(optional)> <--perf-dir dir(optional)> <--out file(optional)> <appPath> <ordering=graphFile ...>\n", argv[0]);
+        exit(1);
+    }
+    const char* appList = NULL;
+    directions = splitList("pull,push");
+    threads = splitList("single,multi");
+    int i = 1;
+    for (; i < argc-2; i++){
+      char * opt = argv[i];
+      if (strcmp(opt, "--trials") == 0 && i+1 < argc-2) trials = atoi(argv[++i]);
+      else if (strcmp(opt, "--warmup") == 0 && i+1 < argc-2) warmup = atoi(argv[++i]);
+      else if (strcmp(opt, "--cpus") == 0 && i+1 < argc-2) cpus = parseCpus(argv[++i]);
+      else if (strcmp(opt, "--apps") == 0 && i+1 < argc-2) appList = argv[++i];
+      else if (strcmp(opt, "--directions") == 0 && i+1 < argc-2) directions = splitList(argv[++i]);
+      else if (strcmp(opt, "--threads") == 0 && i+1 < argc-2) threads = splitList(argv[++i]);
+      else if (strcmp(opt, "--perf-dir") == 0 && i+1 < argc-2) perfDir = argv[++i];
+      else if (strcmp(opt, "--out") == 0 && i+1 < argc-2) outFile = argv[++i];
+      else break;
+    }
+    if (trials == 0)
+    {
+        fputs("--trials must be at least 1\n", stderr);
+        exit(1);
+    }
+    // all the cpus the runner may use
+    if (cpus.empty())
+    {
+        cpu_set_t set;
+        sched_getaffinity(0, sizeof(set), &set);
+        for (int c=0; c<CPU_SETSIZE; c++)
+            if (CPU_ISSET(c, &set))
+                cpus.push_back(c);
+    }
+    string appPath = argv[i++];
+    mkdir(perfDir, 0755);
+
+    FILE* fp = fopen(outFile, "w");
+    if (fp == NULL)
+    {
+        fputs("file error\n", stderr);
+        exit(1);
+    }
+    fprintf(fp, "{\"trials\": %u, \"warmup\": %u, \"cpus\": [", trials, warmup);
+    for (size_t c=0; c<cpus.size(); c++)
+        fprintf(fp, "%s%d", (c > 0) ? ", " : "", cpus[c]);
+    fprintf(fp, "],\n \"results\": [");
+
+    bool first = true;
+    for (; i < argc; i++)
+    {
+        string spec = argv[i];
+        size_t eq = spec.find('=');
+        if (eq == string::npos)
+        {
+            fprintf(stderr, "expected ordering=graphFile, got %s\n", argv[i]);
+            exit(1);
+        }
+        string ordering = spec.substr(0, eq), graphFile = spec.substr(eq + 1);
+        string graph = baseName(graphFile);
+        // as in simulation_runner.sh, the weighted graphs go to bfs and sssp
+        vector<string> graphApps = (appList != NULL) ? splitList(appList)
+                                 : splitList(isWeighted(graphFile) ? "bfs,sssp" : "pagerank,cc");
+
+        for (size_t a=0; a<graphApps.size(); a++)
+            for (size_t t=0; t<threads.size(); t++)
+                for (size_t d=0; d<directions.size(); d++)
+                {
+                    const string& app = graphApps[a];
+                    string binary = appPath + "/" + threads[t] + "/" + directions[d] + "/" + app;
+                    string perfFile = string(perfDir) + "/" + ordering + "_" + app + "_" + graph + "_" + threads[t] + "_" + directions[d] + ".json";
+                    bool multi = threads[t] != "single";
+                    fprintf(stderr, "%s %s %s %s %s\n", ordering.c_str(), graph.c_str(), app.c_str(), threads[t].c_str(), directions[d].c_str());
+
+                    // logger.cpp appends, the file of an earlier sweep goes first
+                    unlink(perfFile.c_str());
+                    vector<double> runs;
+                    if (runApp(binary, graphFile, multi, perfFile))
+                        runs = readRuns(perfFile.c_str());
+                    if (runs.empty())
+                        fprintf(stderr, "%s failed on %s\n", binary.c_str(), graphFile.c_str());
+
+                    fprintf(fp, "%s\n  {\"graph\": \"%s\", \"ordering\": \"%s\", \"app\": \"%s\", \"direction\": \"%s\", "
+                                "\"threads\": \"%s\", \"num_threads\": %zu, \"runs\": [",
+                            first ? "" : ",", graph.c_str(), ordering.c_str(), app.c_str(), directions[d].c_str(),
+                            threads[t].c_str(), multi ? cpus.size() : (size_t) 1);
+                    first = false;
+                    for (size_t r=0; r<runs.size(); r++)
+                        fprintf(fp, "%s%.9f", (r > 0) ? ", " : "", runs[r]);
+                    fprintf(fp, "], ");
+                    if (runs.empty())
+                        fprintf(fp, "\"error\": true}");
+                    else
+                    {
+                        writeStats(fp, summarize(runs));
+                        fprintf(fp, "}");
+                    }
+                    fflush(fp);
+                }
+    }
+    fprintf(fp, "\n ]}\n");
+    fclose(fp);
+    return 0;
+}
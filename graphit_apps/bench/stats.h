@@ -0,0 +1,76 @@
+#ifndef STATS_HEADER_INCL
+#define STATS_HEADER_INCL
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+// summary of the runtimes of the trials of one configuration
+struct runStats
+{
+    size_t n;
+    double mean, stddev, min, max, median, p95;
+    // 95% confidence intervals, of the mean (student t) and of the median
+    // (order statistics, no assumption on the distribution)
+    double meanLow, meanHigh, medianLow, medianHigh;
+};
+
+// two sided 95% quantile of the t distribution with df degrees of freedom
+static inline double tQuantile (size_t df)
+{
+    static const double table[30] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                     2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                     2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (df == 0)
+        return 0;
+    if (df <= 30)
+        return table[df-1];
+    // first cornish-fisher term, within 0.001 of the table past 30
+    return 1.96 + (1.96*1.96*1.96 + 1.96) / (4.0 * df);
+}
+
+static inline runStats summarize (std::vector<double> x)
+{
+    runStats S = {};
+    S.n = x.size();
+    if (S.n == 0)
+        return S;
+    std::sort(x.begin(), x.end());
+    size_t n = S.n;
+
+    double sum = 0;
+    for (size_t i=0; i<n; i++)
+        sum += x[i];
+    S.mean = sum / n;
+    double ss = 0;
+    for (size_t i=0; i<n; i++)
+        ss += (x[i] - S.mean) * (x[i] - S.mean);
+    S.stddev = (n > 1) ? sqrt(ss / (n - 1)) : 0;
+    S.min = x[0];
+    S.max = x[n-1];
+    S.median = (n % 2 == 1) ? x[n/2] : (x[n/2 - 1] + x[n/2]) / 2;
+    // nearest rank
+    S.p95 = x[(size_t) ceil(0.95 * n) - 1];
+
+    double h = tQuantile(n - 1) * S.stddev / sqrt((double) n);
+    S.meanLow = S.mean - h;
+    S.meanHigh = S.mean + h;
+
+    // ranks n/2 -+ 1.96 sqrt(n)/2 of the binomial(n, 1/2), clamped to the sample
+    double r = 1.96 * sqrt((double) n) / 2;
+    long lo = (long) floor(n / 2.0 - r), hi = (long) ceil(n / 2.0 + r);
+    S.medianLow = x[std::max(lo, 1L) - 1];
+    S.medianHigh = x[std::min(hi, (long) n) - 1];
+    return S;
+}
+
+// the fields of S as the members of a json object, without the braces
+static inline void writeStats (FILE* fp, const runStats& S)
+{
+    fprintf(fp, "\"trials\": %zu, \"median\": %.9f, \"p95\": %.9f, \"mean\": %.9f, \"stddev\": %.9f, "
+                "\"min\": %.9f, \"max\": %.9f, \"ci95_mean\": [%.9f, %.9f], \"ci95_median\": [%.9f, %.9f]",
+            S.n, S.median, S.p95, S.mean, S.stddev, S.min, S.max, S.meanLow, S.meanHigh, S.medianLow, S.medianHigh);
+}
+
+#endif
@@ -0,0 +1,291 @@
+// the runtime first, so the generated apps included below in their own namespaces
+// find its headers already included
+#include "intrinsics.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#ifdef OPENMP
+#include <omp.h>
+#endif
+#include "../bench/stats.h"
+
+// the *_export.gt apps compiled with the pull and push schedules by compile_runner.sh,
+// each defines the same globals and functors
+namespace pagerank_pull {
+#include "pagerank_pull.cpp"
+}
+namespace pagerank_push {
+#include "pagerank_push.cpp"
+}
+namespace bfs_pull {
+#include "bfs_pull.cpp"
+}
+namespace bfs_push {
+#include "bfs_push.cpp"
+}
+namespace cc_pull {
+#include "cc_pull.cpp"
+}
+namespace cc_push {
+#include "cc_push.cpp"
+}
+namespace sssp_pull {
+#include "sssp_pull.cpp"
+}
+namespace sssp_push {
+#include "sssp_push.cpp"
+}
+
+using namespace std;
+
+// hardware counters around the timed runs, see ../logger.cpp
+void perf_begin(std::string region);
+void perf_end(std::string region);
+
+// one app compiled with one schedule: load keeps the graph (and allocates the
+// vectors of the app), run is one trial, release drops the graph and the vectors again
+struct hostApp
+{
+    const char* name;
+    const char* direction;
+    bool weighted;
+    void (*load)(Graph&);
+    void (*loadWeighted)(WGraph&);
+    void (*run)();
+    void (*release)();
+};
+
+// the vectors each <app>_load allocates
+#define pagerank_vectors(ns) \
+    delete[] ns::old_rank; delete[] ns::new_rank; delete[] ns::contrib; delete[] ns::error; delete[] ns::out_degree;
+#define bfs_vectors(ns) delete[] ns::parent;
+#define cc_vectors(ns) delete[] ns::IDs;
+#define sssp_vectors(ns) delete[] ns::SP;
+
+// assigning a graph drops the dedup flags of the push schedules but keeps the pointer
+// to them, it is cleared so the next graph allocates its own
+#define HOST_APP(app, dir) \
+    {#app, #dir, false, [](Graph& g) { app##_##dir::app##_load()(g); }, NULL, \
+     []() { app##_##dir::app##_run()(); }, []() { app##_##dir::edges = Graph(); app##_##dir::edges.set_flags_(NULL); \
+           app##_vectors(app##_##dir) }}
+#define HOST_WEIGHTED_APP(app, dir) \
+    {#app, #dir, true, NULL, [](WGraph& g) { app##_##dir::app##_load()(g); }, \
+     []() { app##_##dir::app##_run()(); }, []() { app##_##dir::edges = WGraph(); app##_##dir::edges.set_flags_(NULL); \
+           app##_vectors(app##_##dir) }}
+
+static hostApp hostApps[] = {
+    HOST_APP(pagerank, pull), HOST_APP(pagerank, push),
+    HOST_APP(bfs, pull), HOST_APP(bfs, push),
+    HOST_APP(cc, pull), HOST_APP(cc, push),
+    HOST_WEIGHTED_APP(sssp, pull), HOST_WEIGHTED_APP(sssp, push),
+};
+#define NUM_HOST_APPS (sizeof(hostApps) / sizeof(hostApps[0]))
+
+unsigned int numTrials = 10, numWarmup = 2;
+const char* outFile = "statistics.json";
+vector<string> directions;
+vector<int> threadCounts;
+
+static vector<string> splitList (const char* s)
+{
+    vector<string> list;
+    string cur;
+    for (const char* p = s; ; p++)
+    {
+        if (*p == ',' || *p == '\0')
+        {
+            if (!cur.empty())
+                list.push_back(cur);
+            cur.clear();
+            if (*p == '\0')
+                break;
+        }
+        else
+            cur += *p;
+    }
+    return list;
+}
+
+static double now ()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static string baseName (const string& path)
+{
+    size_t slash = path.rfind('/');
+    string name = (slash == string::npos) ? path : path.substr(slash + 1);
+    size_t dot = name.rfind('.');
+    return (dot == string::npos || dot == 0) ? name : name.substr(0, dot);
+}
+
+static bool isWeighted (const string& path)
+{
+    size_t dot = path.rfind('.');
+    return dot != string::npos && (path.substr(dot) == ".wel" || path.substr(dot) == ".wsg");
+}
+
+// the unweighted graph of a weighted one, for bfs on a .wel without reading it again
+static Graph dropWeights (WGraph& wg, CLBase& cli)
+{
+    pvector< EdgePair<NodeID, NodeID> > el(wg.num_edges_directed());
+    size_t k = 0;
+    for (NodeID u=0; u<wg.num_nodes(); u++)
+        for (WNode w : wg.out_neigh(u))
+            el[k++] = EdgePair<NodeID, NodeID>(u, w.v);
+    Builder builder(cli);
+    return builder.MakeGraphFromEL(el);
+}
+
+static void setThreads (int t)
+{
+#ifdef OPENMP
+    omp_set_num_threads(t);
+#endif
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage : %s <--trials n(optional)> <--warmup n(optional)> <--apps pagerank,bfs,cc,sssp(optional)> <--directions pull,push(optional)> <--threads 1,8(optional)> <--out file(optional)> <ordering=graphFile ...>\n", argv[0]);
+        exit(1);
+    }
+    const char* appList = NULL;
+    directions = splitList("pull,push");
+    int i = 1;
+    for (; i < argc-1; i++){
+      char * opt = argv[i];
+      if (strcmp(opt, "--trials") == 0 && i+1 < argc-1) numTrials = atoi(argv[++i]);
+      else if (strcmp(opt, "--warmup") == 0 && i+1 < argc-1) numWarmup = atoi(argv[++i]);
+      else if (strcmp(opt, "--apps") == 0 && i+1 < argc-1) appList = argv[++i];
+      else if (strcmp(opt, "--directions") == 0 && i+1 < argc-1) directions = splitList(argv[++i]);
+      else if (strcmp(opt, "--threads") == 0 && i+1 < argc-1)
+      {
+          vector<string> list = splitList(argv[++i]);
+          for (size_t t=0; t<list.size(); t++)
+              threadCounts.push_back(atoi(list[t].c_str()));
+      }
+      else if (strcmp(opt, "--out") == 0 && i+1 < argc-1) outFile = argv[++i];
+      else break;
+    }
+    if (numTrials == 0)
+    {
+        fputs("--trials must be at least 1\n", stderr);
+        exit(1);
+    }
+    // single threaded, then on every cpu the host may use
+    if (threadCounts.empty())
+    {
+        cpu_set_t set;
+        sched_getaffinity(0, sizeof(set), &set);
+        threadCounts.push_back(1);
+        if (CPU_COUNT(&set) > 1)
+            threadCounts.push_back(CPU_COUNT(&set));
+    }
+
+    FILE* fp = fopen(outFile, "w");
+    if (fp == NULL)
+    {
+        fputs("file error\n", stderr);
+        exit(1);
+    }
+    fprintf(fp, "{\"trials\": %u, \"warmup\": %u,\n \"results\": [", numTrials, numWarmup);
+
+    bool first = true;
+    for (; i < argc; i++)
+    {
+        string spec = argv[i];
+        size_t eq = spec.find('=');
+        if (eq == string::npos)
+        {
+            fprintf(stderr, "expected ordering=graphFile, got %s\n", argv[i]);
+            exit(1);
+        }
+        string ordering = spec.substr(0, eq), graphFile = spec.substr(eq + 1);
+        string graph = baseName(graphFile);
+        bool weighted = isWeighted(graphFile);
+        // as in bench, the weighted graphs go to bfs and sssp
+        vector<string> apps = (appList != NULL) ? splitList(appList)
+                            : splitList(weighted ? "bfs,sssp" : "pagerank,cc");
+
+        // the one load of the graph, through the gapbs builder like builtin_loadEdgesFromFile
+        double start = now();
+        CLBase cli(graphFile);
+        Graph g;
+        WGraph wg;
+        if (weighted)
+        {
+            WeightedBuilder builder(cli);
+            wg = builder.MakeGraph();
+            g = dropWeights(wg, cli);
+        }
+        else
+        {
+            Builder builder(cli);
+            g = builder.MakeGraph();
+        }
+        double loadTime = now() - start;
+        fprintf(stderr, "%s %s loaded in %f s\n", ordering.c_str(), graph.c_str(), loadTime);
+
+        for (size_t a=0; a<apps.size(); a++)
+            for (size_t d=0; d<directions.size(); d++)
+            {
+                hostApp* A = NULL;
+                for (unsigned int k=0; k<NUM_HOST_APPS; k++)
+                    if (apps[a] == hostApps[k].name && directions[d] == hostApps[k].direction)
+                        A = &hostApps[k];
+                if (A == NULL || (A->weighted && !weighted))
+                {
+                    fprintf(stderr, "no %s %s for %s\n", apps[a].c_str(), directions[d].c_str(), graphFile.c_str());
+                    continue;
+                }
+                if (A->weighted)
+                    A->loadWeighted(wg);
+                else
+                    A->load(g);
+
+                for (size_t t=0; t<threadCounts.size(); t++)
+                {
+                    setThreads(threadCounts[t]);
+                    fprintf(stderr, "%s %s %s %s %d threads\n", ordering.c_str(), graph.c_str(), A->name, A->direction, threadCounts[t]);
+                    for (unsigned int w=0; w<numWarmup; w++)
+                        A->run();
+                    char region[256];
+                    snprintf(region, sizeof(region), "%s/%s/%s_%s_%d", ordering.c_str(), graph.c_str(), A->name, A->direction, threadCounts[t]);
+                    vector<double> runs;
+                    for (unsigned int r=0; r<numTrials; r++)
+                    {
+                        perf_begin(region);
+                        double begin = now();
+                        A->run();
+                        runs.push_back(now() - begin);
+                        perf_end(region);
+                    }
+
+                    fprintf(fp, "%s\n  {\"graph\": \"%s\", \"ordering\": \"%s\", \"app\": \"%s\", \"direction\": \"%s\", "
+                                "\"threads\": \"%s\", \"num_threads\": %d, \"load_seconds\": %.9f, \"runs\": [",
+                            first ? "" : ",", graph.c_str(), ordering.c_str(), A->name, A->direction,
+                            (threadCounts[t] > 1) ? "multi" : "single", threadCounts[t], loadTime);
+                    first = false;
+                    for (size_t r=0; r<runs.size(); r++)
+                        fprintf(fp, "%s%.9f", (r > 0) ? ", " : "", runs[r]);
+                    fprintf(fp, "], ");
+                    writeStats(fp, summarize(runs));
+                    fprintf(fp, "}");
+                    fflush(fp);
+                }
+                A->release();
+            }
+    }
+    fprintf(fp, "\n ]}\n");
+    fclose(fp);
+    return 0;
+}
@@ -1,7 +1,198 @@
 #include <iostream>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+// hardware counters of the process, opened before main so the openmp threads
+// created later inherit them. a counter the machine (or perf_event_paranoid)
+// does not allow stays closed and is reported as null
+struct perfCounter {
+	const char *name;
+	unsigned int type;
+	unsigned long long config;
+	int fd;
+};
+
+#define HW_CACHE_MISS(cache) ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static perfCounter counters[] = {
+	{"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1},
+	{"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, -1},
+	// the generic cache-misses event, last level misses on x86
+	{"llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, -1},
+	{"dtlb_misses", PERF_TYPE_HW_CACHE, HW_CACHE_MISS(PERF_COUNT_HW_CACHE_DTLB), -1},
+	{"stalled_cycles_frontend", PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_FRONTEND, -1},
+	{"stalled_cycles_backend", PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND, -1},
+};
+#define NUM_COUNTERS (sizeof(counters) / sizeof(counters[0]))
+
+// value, time enabled, time running of a counter
+struct perfReading {
+	unsigned long long v[3];
+};
+
+struct perfSample {
+	double seconds;
+	double count[NUM_COUNTERS];
+};
+
+struct perfRegion {
+	std::string name;
+	bool open;
+	double start;
+	perfReading begin[NUM_COUNTERS];
+	std::vector<perfSample> samples;
+};
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void readCounters(perfReading *r) {
+	for (unsigned int c = 0; c < NUM_COUNTERS; c++) {
+		if (counters[c].fd < 0 || read(counters[c].fd, r[c].v, sizeof(r[c].v)) != sizeof(r[c].v))
+			r[c].v[0] = r[c].v[1] = r[c].v[2] = 0;
+	}
+}
+
+static int envInt(const char *name, int value) {
+	const char *s = getenv(name);
+	return (s != NULL && *s != '\0') ? atoi(s) : value;
+}
+
+static void writeCount(FILE *fp, const char *name, double count, bool available) {
+	if (available)
+		fprintf(fp, ", \"%s\": %.0f", name, count);
+	else
+		fprintf(fp, ", \"%s\": null", name);
+}
+
+// the regions in the order they were first entered and the runtimes passed to logger,
+// appended as one json line to $GRAPHIT_PERF_OUT (perf.json) when the app exits.
+// the first $GRAPHIT_WARMUP runs (0) are left out of both
+static struct perfState {
+	std::vector<perfRegion> regions;
+	std::map<std::string, size_t> index;
+	std::vector<double> runs;
+	int warmup, trials, done;
+
+	perfState() {
+		warmup = envInt("GRAPHIT_WARMUP", 0);
+		trials = envInt("GRAPHIT_TRIALS", 1);
+		done = 0;
+		for (unsigned int c = 0; c < NUM_COUNTERS; c++) {
+			struct perf_event_attr attr;
+			memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = counters[c].type;
+			attr.config = counters[c].config;
+			attr.inherit = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			counters[c].fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+		}
+	}
+
+	~perfState() {
+		const char *out = getenv("GRAPHIT_PERF_OUT");
+		FILE *fp = fopen((out != NULL) ? out : "perf.json", "a");
+		if (fp == NULL) {
+			fputs("File error\n", stderr);
+			return;
+		}
+		fprintf(fp, "{\"runs\": [");
+		for (size_t i = 0; i < runs.size(); i++)
+			fprintf(fp, "%s%.9f", (i > 0) ? ", " : "", runs[i]);
+		fprintf(fp, "], \"regions\": {");
+		for (size_t i = 0; i < regions.size(); i++) {
+			perfRegion &R = regions[i];
+			perfSample total;
+			memset(&total, 0, sizeof(total));
+			for (size_t s = 0; s < R.samples.size(); s++) {
+				total.seconds += R.samples[s].seconds;
+				for (unsigned int c = 0; c < NUM_COUNTERS; c++)
+					total.count[c] += R.samples[s].count[c];
+			}
+			fprintf(fp, "%s\"%s\": {\"calls\": %zu, \"seconds\": %.9f", (i > 0) ? ", " : "",
+			        R.name.c_str(), R.samples.size(), total.seconds);
+			for (unsigned int c = 0; c < NUM_COUNTERS; c++)
+				writeCount(fp, counters[c].name, total.count[c], counters[c].fd >= 0);
+			fprintf(fp, ", \"iterations\": [");
+			for (size_t s = 0; s < R.samples.size(); s++) {
+				fprintf(fp, "%s{\"seconds\": %.9f", (s > 0) ? ", " : "", R.samples[s].seconds);
+				for (unsigned int c = 0; c < NUM_COUNTERS; c++)
+					writeCount(fp, counters[c].name, R.samples[s].count[c], counters[c].fd >= 0);
+				fprintf(fp, "}");
+			}
+			fprintf(fp, "]}");
+		}
+		fprintf(fp, "}}\n");
+		fclose(fp);
+		for (unsigned int c = 0; c < NUM_COUNTERS; c++)
+			if (counters[c].fd >= 0)
+				close(counters[c].fd);
+	}
+} perf;
+
+// starts a sample of region, one sample per call, so a region around the apply in a
+// loop gets one sample per iteration
+void perf_begin(std::string region) {
+	std::map<std::string, size_t>::iterator it = perf.index.find(region);
+	if (it == perf.index.end()) {
+		it = perf.index.insert(std::make_pair(region, perf.regions.size())).first;
+		perf.regions.push_back(perfRegion());
+		perf.regions.back().name = region;
+		perf.regions.back().open = false;
+	}
+	perfRegion &R = perf.regions[it->second];
+	R.open = true;
+	readCounters(R.begin);
+	R.start = now();
+}
+
+// ends the sample of region started by perf_begin, the counts are scaled by the
+// share of the time the counter was scheduled when the pmu was multiplexed
+void perf_end(std::string region) {
+	double end = now();
+	perfReading stop[NUM_COUNTERS];
+	readCounters(stop);
+	std::map<std::string, size_t>::iterator it = perf.index.find(region);
+	if (it == perf.index.end() || !perf.regions[it->second].open)
+		return;
+	perfRegion &R = perf.regions[it->second];
+	R.open = false;
+	if (perf.done < perf.warmup)
+		return;
+	perfSample S;
+	S.seconds = end - R.start;
+	for (unsigned int c = 0; c < NUM_COUNTERS; c++) {
+		double value = stop[c].v[0] - R.begin[c].v[0];
+		unsigned long long enabled = stop[c].v[1] - R.begin[c].v[1];
+		unsigned long long running = stop[c].v[2] - R.begin[c].v[2];
+		S.count[c] = (running > 0 && running < enabled) ? value * enabled / running : value;
+	}
+	R.samples.push_back(S);
+}
+
+// number of runs the main loop of an app does, $GRAPHIT_WARMUP + $GRAPHIT_TRIALS (1),
+// every run ends with a call to logger
+int trials() {
+	return perf.warmup + perf.trials;
+}
 
 void logger(double runtime) {
+	if (perf.done++ < perf.warmup)
+		return;
 	FILE *fp = fopen("log.txt", "a");
 	if (fp == NULL) {
 		fputs("File error\n", stderr);
@@ -9,4 +200,5 @@ void logger(double runtime) {
 	}
 	fprintf(fp, "%f\n", runtime);
 	fclose(fp);
+	perf.runs.push_back(runtime);
 }
@@ -0,0 +1,212 @@
+#include "OMEGA_API.h"
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+
+#ifndef OMEGA_EMULATE
+  #error OMEGA_API_emu.cpp is only built with -DOMEGA_EMULATE
+#endif
+
+// ---------------------------Begin: Software OMEGA Implementation-----------------------
+
+static long envLong(const char* name, long def) {
+  const char* s = getenv(name);
+  return (s != nullptr && *s != '\0') ? atol(s) : def;
+}
+
+// Atomic min/add on the bits of a float or double, as the PISC does in its SPM,
+// the value and its bits are converted with memcpy so -O3 can't reorder them
+template <typename T, typename B>
+static bool casUpdate(T* dst, T val, bool is_min) {
+  volatile B* bits = (volatile B*)dst;
+  while (true) {
+    B old_bits = *bits;
+    T old_val;
+    memcpy(&old_val, &old_bits, sizeof(T));
+    T new_val  = is_min ? val : old_val + val;
+    if (is_min && !(val < old_val))
+      return false;
+    B new_bits;
+    memcpy(&new_bits, &new_val, sizeof(B));
+    if (__sync_bool_compare_and_swap(bits, old_bits, new_bits))
+      return true;
+  }
+}
+
+static bool minUpdate(int* dst, int val) {
+  int old_val = *(volatile int*)dst;
+  while (val < old_val) {
+    if (__sync_bool_compare_and_swap(dst, old_val, val))
+      return true;
+    old_val = *(volatile int*)dst;
+  }
+  return false;
+}
+
+OMEGA_API::~OMEGA_API() {
+  FILE* fp = stderr;
+  if (stats_file != nullptr && (fp = fopen(stats_file, "a")) == nullptr) {
+    fputs("file error\n", stderr);
+    fp = stderr;
+  }
+  printStats(fp);
+  if (fp != stderr) fclose(fp);
+
+  for (int i = 0; i < OMEGA_EMU_MAX_THREADS; i++)
+    if (threads[i].buffer != nullptr) delete [] threads[i].buffer;
+  if (mapped_next != nullptr) delete [] mapped_next;
+}
+
+void OMEGA_API::init() {
+  cores = (int)envLong("OMEGA_CORES", 16);
+  if (cores < 1) cores = 1;
+  max_mapped_count = envLong("OMEGA_SPM_VERTICES",
+                             cores * envLong("OMEGA_SPM_BYTES", 1 << 20) / VERTEXLINE_SIZE);
+  combine_entries  = (int)envLong("OMEGA_COMBINE", 0);
+  stats_file       = getenv("OMEGA_STATS");
+
+  for (int i = 0; i < OMEGA_EMU_MAX_THREADS; i++)
+    threads[i].last_miss = -1;
+
+  mapped_next = new bool [max_mapped_count];
+  ligra::parallel_for_lambda((long)0, (long)max_mapped_count, [&] (long i) {
+    mapped_next[i] = 0;
+  }, CACHELINE_SIZE / sizeof(bool));
+}
+
+void OMEGA_API::enableAtomic(char op) {
+  atomic_op      = op;
+  atomic_enabled = true;
+}
+
+void OMEGA_API::disableAtomic() {
+  waitForPISCs();
+  atomic_enabled = false;
+}
+
+void OMEGA_API::mapSpareActive(uintE *outEdges, long outEdgeCount) {
+  sparse_active = outEdges;
+  is_sparse     = true;
+}
+
+void OMEGA_API::unmapSparseActive() {
+  sparse_active = nullptr;
+  is_sparse     = false;
+}
+
+// Called after the parallel loop of an apply, drains the combining buffers of all threads
+void OMEGA_API::waitForPISCs() {
+  if (combine_entries == 0) return;
+  ligra::parallel_for_lambda((int)0, (int)OMEGA_EMU_MAX_THREADS, [&] (int i) {
+    if (threads[i].buffer != nullptr) flush(threads[i]);
+  }, 1);
+}
+
+// Applies one op to the mapped array, returns whether it changed the vertex
+bool OMEGA_API::update(threadState& t, NodeID dst_ID, const void* val, const void* cmp_val) {
+  bool success;
+  switch (atomic_op) {
+    case OMEGA_ATOMIC_SUM_INT:
+      __sync_fetch_and_add((int*)curr_data + dst_ID, *(const int*)val);
+      success = true;
+      break;
+    case OMEGA_ATOMIC_SUM_FLOAT:
+      success = casUpdate<float, uint32_t>((float*)curr_data + dst_ID, *(const float*)val, false);
+      break;
+    case OMEGA_ATOMIC_SUM_DOUBLE:
+      success = casUpdate<double, uint64_t>((double*)curr_data + dst_ID, *(const double*)val, false);
+      break;
+    case OMEGA_ATOMIC_MIN_INT:
+      success = minUpdate((int*)curr_data + dst_ID, *(const int*)val);
+      break;
+    case OMEGA_ATOMIC_MIN_FLOAT:
+      success = casUpdate<float, uint32_t>((float*)curr_data + dst_ID, *(const float*)val, true);
+      break;
+    case OMEGA_ATOMIC_MIN_DOUBLE:
+      success = casUpdate<double, uint64_t>((double*)curr_data + dst_ID, *(const double*)val, true);
+      break;
+    case OMEGA_ATOMIC_CAS_32:
+      success = __sync_bool_compare_and_swap((uint32_t*)curr_data + dst_ID,
+                                             *(const uint32_t*)cmp_val, *(const uint32_t*)val);
+      break;
+    default:
+      std::cout << "OMEGA: Unknown atomic op " << atomic_op << std::endl;
+      exit(1);
+  }
+  if (success) t.active++;
+  return success;
+}
+
+// A direct mapped buffer of partial sums, a conflict writes the old entry back
+void OMEGA_API::combine(threadState& t, NodeID dst_ID, const void* val) {
+  if (t.buffer == nullptr) {
+    t.buffer = new combineEntry [combine_entries];
+    for (int i = 0; i < combine_entries; i++) t.buffer[i].id = -1;
+  }
+  combineEntry& e = t.buffer[dst_ID % combine_entries];
+  if (e.id != dst_ID) {
+    if (e.id >= 0) {
+      update(t, e.id, &e.val, nullptr);
+      mapped_next[e.id] = true;
+    }
+    e.id    = dst_ID;
+    e.val.d = 0;
+  } else {
+    t.combined++;
+  }
+  switch (atomic_op) {
+    case OMEGA_ATOMIC_SUM_INT:   e.val.i += *(const int*)val;    break;
+    case OMEGA_ATOMIC_SUM_FLOAT: e.val.f += *(const float*)val;  break;
+    default:                     e.val.d += *(const double*)val; break;
+  }
+}
+
+void OMEGA_API::flush(threadState& t) {
+  for (int i = 0; i < combine_entries; i++) {
+    combineEntry& e = t.buffer[i];
+    if (e.id < 0) continue;
+    update(t, e.id, &e.val, nullptr);
+    mapped_next[e.id] = true;
+    e.id = -1;
+  }
+}
+
+uint64_t OMEGA_API::getActiveCount() {
+  uint64_t n = 0;
+  for (int i = 0; i < OMEGA_EMU_MAX_THREADS; i++) n += threads[i].active;
+  return n;
+}
+
+uint64_t OMEGA_API::spmLocalHits() {
+  uint64_t n = 0;
+  for (int i = 0; i < OMEGA_EMU_MAX_THREADS; i++) n += threads[i].local_hits;
+  return n;
+}
+
+uint64_t OMEGA_API::spmRemoteHits() {
+  uint64_t n = 0;
+  for (int i = 0; i < OMEGA_EMU_MAX_THREADS; i++) n += threads[i].remote_hits;
+  return n;
+}
+
+uint64_t OMEGA_API::spmMisses() {
+  uint64_t n = 0;
+  for (int i = 0; i < OMEGA_EMU_MAX_THREADS; i++) n += threads[i].misses;
+  return n;
+}
+
+// One json line, combined counts the ops that a buffer merged into an earlier op
+void OMEGA_API::printStats(FILE* fp) {
+  uint64_t local = spmLocalHits(), remote = spmRemoteHits(), misses = spmMisses();
+  uint64_t combined = 0;
+  for (int i = 0; i < OMEGA_EMU_MAX_THREADS; i++) combined += threads[i].combined;
+  uint64_t total = local + remote + misses;
+  fprintf(fp, "{\"spm_vertices\": %ld, \"cores\": %d, \"combine_entries\": %d, "
+              "\"local_hits\": %" PRIu64 ", \"remote_hits\": %" PRIu64 ", \"misses\": %" PRIu64 ", "
+              "\"combined\": %" PRIu64 ", \"hit_rate\": %f}\n",
+          max_mapped_count, cores, combine_entries, local, remote, misses, combined,
+          total > 0 ? (double)(local + remote) / total : 0.0);
+}
+
+// ----------------------------End: Software OMEGA Implementation------------------------
@@ -0,0 +1,13 @@
+#!/bin/bash
+# builds the acc apps against the software OMEGA (OMEGA_API_emu.h) to run natively, see emu_run_acc.sh
+path=../benchmarks
+apps=(pagerank bfs cc sssp)
+directions=(pull push push-pull)
+for a in "${apps[@]}";do
+	for d in "${directions[@]}"; do
+		src=$path/$a/graphit_compiled/acc/${a}_benchmark.gt__${d}-omega.gt__.cpp
+		[ -f $src ] || continue
+		mkdir -p $path/$a/executables_emu/acc
+		g++ -o $path/$a/executables_emu/acc/${a}_${d}-omega -std=c++14 -DOMEGA_EMULATE -DOPENMP -fopenmp -I graphit/src/runtime_lib/ -O3 $src OMEGA_API.cpp OMEGA_API_emu.cpp
+	done
+done
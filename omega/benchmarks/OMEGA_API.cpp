@@ -22,6 +22,9 @@ template void OMEGA_API::unmap(bool*     data_dst);
 
 // ----------------------------End: Template instantiations------------------------------
 
+// The software OMEGA is in OMEGA_API_emu.cpp
+#ifndef OMEGA_EMULATE
+
 // ---------------------------Begin: OMEGA Control Registers-----------------------------
 
 // Mostly copied from accelerated Ligra
@@ -245,3 +248,5 @@ void OMEGA_API::unmapSparseActive() {
 }
 
 // ----------------------------End: OMEGA_API Implementation-----------------------------
+
+#endif // OMEGA_EMULATE
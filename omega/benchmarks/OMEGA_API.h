@@ -20,6 +20,13 @@
 #define OMEGA_ATOMIC_MIN_DOUBLE 'i'
 #define OMEGA_ATOMIC_CAS_32     'j'
 
+#ifdef OMEGA_EMULATE
+
+// Software OMEGA for running the apps on a normal host
+#include "OMEGA_API_emu.h"
+
+#else
+
 // Only one instance of this class should exist at any given time
 class OMEGA_API {
 public:
@@ -147,6 +154,8 @@ inline void OMEGA_API::waitForPISCs() {
   while (*outstanding_pisc_ops) {};
 }
 
+#endif // OMEGA_EMULATE
+
 // Function wrappers for class methods since the GraphIt compiler doesn't
 // natively support calling class methods (could be done as a variable as 
 // a variable statement, but that's kind of clunky).
@@ -233,4 +242,18 @@ inline const int omegaGrainSize() {
   return omega.grainSize();
 }
 
+#ifdef OMEGA_EMULATE
+inline uint64_t omegaSpmLocalHits() {
+  return omega.spmLocalHits();
+}
+
+inline uint64_t omegaSpmRemoteHits() {
+  return omega.spmRemoteHits();
+}
+
+inline uint64_t omegaSpmMisses() {
+  return omega.spmMisses();
+}
+#endif
+
 #endif
@@ -0,0 +1,209 @@
+#ifndef _OMEGA_API_EMU_H_
+#define _OMEGA_API_EMU_H_
+
+// Software OMEGA, included by OMEGA_API.h when built with -DOMEGA_EMULATE (and
+// OMEGA_API_emu.cpp) so that the acc apps run natively instead of in gem5.
+//
+// The generated code reads mapped arrays through their own pointers, so mapped data
+// stays in place: the first mappedCount() elements are the scratchpad, split between
+// the emulated cores by (ID / grainSize()) % cores as gem5 does. writeX and cas32 are
+// done by the calling thread, as atomics on the mapped array or, for the sums, through
+// a small combining buffer per thread that waitForPISCs() drains. Every PISC op is an
+// SPM hit, local when the thread is the home core of the vertex and remote otherwise,
+// and every inSPM() miss while atomics are enabled is an SPM miss.
+
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+// Thread slots for the per-thread state and counters
+#define OMEGA_EMU_MAX_THREADS 256
+
+class OMEGA_API {
+public:
+  ~OMEGA_API();
+
+  // Reads the emulated configuration from the environment:
+  //   OMEGA_CORES        cores with an SPM (16, as setWorkers(16) in the apps)
+  //   OMEGA_SPM_BYTES    bytes of SPM per core (1MB, as --vertex_size in gem5_run_acc.sh)
+  //   OMEGA_SPM_VERTICES mapped vertices over all cores, overrides the two above
+  //   OMEGA_COMBINE      entries of the combining buffer per thread (0, plain atomics)
+  //   OMEGA_STATS        file the SPM counts are appended to at exit (stderr)
+  void init();
+
+  template <typename T> void map(T* new_data, long new_data_count);
+
+  template <typename T> void unmap(T* data_dst);
+
+  void enableAtomic(char op);
+  void disableAtomic();
+
+  inline void writeX(int    val, NodeID dst_ID) { pisc(dst_ID, &val, nullptr); }
+  inline void writeX(float  val, NodeID dst_ID) { pisc(dst_ID, &val, nullptr); }
+  inline void writeX(double val, NodeID dst_ID) { pisc(dst_ID, &val, nullptr); }
+
+  inline void cas32(int   val, int   dst_cmp_val, NodeID dst_ID) { pisc(dst_ID, &val, &dst_cmp_val); }
+  inline void cas32(float val, float dst_cmp_val, NodeID dst_ID) { pisc(dst_ID, &val, &dst_cmp_val); }
+
+  void mapSpareActive(uintE *outEdges, long outEdgeCount);
+  void unmapSparseActive();
+  inline void setSparseOffset(uintT offset) { threads[threadSlot()].sparse_offset = offset; }
+  inline bool enableDeduplication()  { dedup_enabled = true;  return true; }
+  inline bool disableDeduplication() { dedup_enabled = false; return true; }
+
+  void waitForPISCs();
+
+  inline volatile bool* getMappedNext()  { return mapped_next; }
+  uint64_t getActiveCount();
+
+  inline const int  mappedCount()    { return curr_data_count;  }
+  inline const bool allInSPM()       { return curr_fits_in_spm; }
+  inline const bool inSPM(NodeID ID);
+  inline const int  grainSize()      { return curr_grain_size;  }
+
+  // SPM counts since init(), over all threads
+  uint64_t spmLocalHits();
+  uint64_t spmRemoteHits();
+  uint64_t spmMisses();
+  void printStats(FILE* fp);
+
+private:
+  struct combineEntry {
+    NodeID id;
+    union { int i; float f; double d; } val;
+  };
+
+  // One cache line (or more) per thread
+  struct alignas(CACHELINE_SIZE) threadState {
+    uint64_t local_hits;
+    uint64_t remote_hits;
+    uint64_t misses;
+    uint64_t combined;
+    uint64_t active;
+    NodeID   last_miss;
+    uintT    sparse_offset;
+    combineEntry* buffer;
+  };
+
+  static inline int threadSlot() {
+#ifdef OPENMP
+    return omp_get_thread_num() % OMEGA_EMU_MAX_THREADS;
+#else
+    return 0;
+#endif
+  }
+
+  inline void pisc(NodeID dst_ID, const void* val, const void* cmp_val);
+  bool update(threadState& t, NodeID dst_ID, const void* val, const void* cmp_val);
+  void combine(threadState& t, NodeID dst_ID, const void* val);
+  void flush(threadState& t);
+
+  char* curr_data       = nullptr;
+  long  curr_data_count = 0;
+  int   curr_grain_size = 0;
+
+  bool* mapped_next     = nullptr;
+
+  bool curr_fits_in_spm = false;
+  long max_mapped_count = 0;
+
+  int  cores            = 16;
+  int  combine_entries  = 0;
+  char atomic_op        = 0;
+  bool atomic_enabled   = false;
+  bool dedup_enabled    = false;
+  bool is_sparse        = false;
+  uintE* sparse_active  = nullptr;
+  const char* stats_file = nullptr;
+
+  threadState threads[OMEGA_EMU_MAX_THREADS] = {};
+};
+
+// The generated push code checks inSPM() for an edge both before and inside the apply
+// function, a thread repeating the miss of the same ID counts it once
+inline const bool OMEGA_API::inSPM(NodeID ID) {
+  if (ID < curr_data_count)
+    return true;
+  if (atomic_enabled) {
+    threadState& t = threads[threadSlot()];
+    if (t.last_miss != ID) {
+      t.misses++;
+      t.last_miss = ID;
+    }
+  }
+  return false;
+}
+
+// As the PISC in gem5: an update that succeeded puts dst_ID at the edge's slot of the
+// sparse active list (only the first one to do so with deduplication, the others get
+// UINT_E_MAX) or sets its valid byte in the dense mapped_next
+inline void OMEGA_API::pisc(NodeID dst_ID, const void* val, const void* cmp_val) {
+  threadState& t = threads[threadSlot()];
+  if ((dst_ID / curr_grain_size) % cores == threadSlot() % cores)
+    t.local_hits++;
+  else
+    t.remote_hits++;
+
+  if (combine_entries > 0 && !is_sparse &&
+      (atomic_op == OMEGA_ATOMIC_SUM_INT || atomic_op == OMEGA_ATOMIC_SUM_FLOAT ||
+       atomic_op == OMEGA_ATOMIC_SUM_DOUBLE)) {
+    combine(t, dst_ID, val);
+    return;
+  }
+
+  bool success = update(t, dst_ID, val, cmp_val);
+  if (is_sparse) {
+    bool first = success && (!dedup_enabled ||
+                             __sync_bool_compare_and_swap(&mapped_next[dst_ID], false, true));
+    sparse_active[t.sparse_offset] = first ? (uintE)dst_ID : UINT_E_MAX;
+  } else if (success) {
+    mapped_next[dst_ID] = true;
+  }
+}
+
+// Mapped data is used in place, mapping only sets the SPM bounds
+template <typename T>
+void OMEGA_API::map(T* new_data, long new_data_count) {
+  // If this data is already mapped, do nothing
+  if (((char*)new_data) == curr_data) {
+    return;
+  }
+
+  if ((char*)curr_data != nullptr) {
+    std::cout << "OMEGA: Must unmap existing data before mapping new data!" << std::endl;
+    exit(1);
+  }
+
+  // Cap the number of mapped elements, if required
+  if (new_data_count > max_mapped_count) {
+    new_data_count   = max_mapped_count;
+    curr_fits_in_spm = false;
+  } else {
+    curr_fits_in_spm = true;
+  }
+
+  curr_grain_size = CACHELINE_SIZE / sizeof(T);
+  curr_data       = (char*)new_data;
+  curr_data_count = new_data_count;
+}
+
+template <typename T>
+void OMEGA_API::unmap(T* data_dst) {
+  // If no data is mapped, do nothing
+  if (curr_data_count == 0) {
+    return;
+  }
+
+  if ((char*)data_dst != curr_data) {
+    T* src = (T*)curr_data;
+    ligra::parallel_for_lambda((long)0, (long)curr_data_count, [&] (long i) {
+      data_dst[i] = src[i];
+    }, curr_grain_size);
+  }
+
+  curr_data       = nullptr;
+  curr_data_count = 0;
+  curr_grain_size = 0;
+}
+
+#endif
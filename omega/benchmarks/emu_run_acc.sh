@@ -0,0 +1,16 @@
+#!/bin/sh
+
+# $1 vertexline_size
+# $2 exe_path
+# $3 input_args
+
+# Runs an app built by OMEGA_BUILDING/script_emu.sh natively with the SPM of
+# gem5_run_acc.sh: 16 cores with 1MB of SPM each, vertexline_size bytes per vertex.
+# The SPM hit/miss counts are appended to $OMEGA_STATS (stderr if unset).
+
+if [ "$#" -ne 3 ]; then
+  echo "Usage: $0 vertexline_size exe_path input_args"
+  exit 1
+fi
+
+OMEGA_CORES=16 OMEGA_SPM_VERTICES=$((16 * 1048576 / $1)) OMP_NUM_THREADS=${OMP_NUM_THREADS:-16} $2 $3
@@ -0,0 +1,57 @@
+#!/bin/bash
+
+# $1 vertexline_size
+# $2 exe_path
+# $3 input_args
+
+# Runs one app under gem5_run_acc.sh's system for every vertex cache
+# replacement policy x associativity x size and writes one csv line per
+# configuration: the SPM hits, misses and replacements over all cores and the
+# bytes the memory controllers read and wrote (the off-chip traffic).
+#
+#   POLICIES      policies to sweep (freqcoll lfu pinned rrip)
+#   ASSOCS        vertex cache associativities (1 2 4 8)
+#   SIZES         vertex cache sizes per core (256kB 512kB 1MB)
+#   MAPPED_LINES  lines mapped to each vertex cache, more than it holds
+#                 over-commit it so that the policies replace (0, one per set)
+#   PINNED_LINES  lines the pinned policy keeps, as spmplan's hot vertices
+#                 per core for a hot-first order (0)
+#   OUT           csv the lines are appended to (spm_sweep.csv)
+#   OUT_DIR       gem5 output directory of each configuration (m5out_sweep)
+
+if [ "$#" -ne 3 ]; then
+  echo "Usage: $0 vertexline_size exe_path input_args"
+  exit 1
+fi
+
+policies=(${POLICIES:-freqcoll lfu pinned rrip})
+assocs=(${ASSOCS:-1 2 4 8})
+sizes=(${SIZES:-256kB 512kB 1MB})
+out=${OUT:-spm_sweep.csv}
+out_dir=${OUT_DIR:-m5out_sweep}
+
+# sum of a stat over all of its instances in stats.txt
+function stat() {
+	awk -v pat="$2" '$1 ~ pat { sum += $2 } END { printf "%d", sum }' $1
+}
+
+if [ ! -s $out ]
+then
+	echo "exe,input,policy,assoc,size,sim_seconds,spm_hits,spm_misses,spm_replacements,dram_bytes_read,dram_bytes_written" > $out
+fi
+
+for p in "${policies[@]}"; do
+	for a in "${assocs[@]}"; do
+		for s in "${sizes[@]}"; do
+			d=$out_dir/$(basename $2)_$(basename "${3##* }")/${p}_${a}_${s}
+			../gem5/build/X86/gem5.opt -d $d ../gem5/configs/example/se.py --cpu-type=detailed --num_cpus=16 --sys-clock=2GHz --caches --cacheline_size=64 --num-dirs=4 --mem-size=4GB --l1i_size=16kB --l1i_assoc=4 --l1d_size=16kB --l1d_assoc=8 --l2cache --num-l2caches=16 --vertexline_size=$1 --vertex_assoc=$a --vertex_size=$s --vertex_replacement=$p --vertex_mapped_lines=${MAPPED_LINES:-0} --vertex_pinned_lines=${PINNED_LINES:-0} --l2_size=1MB --l2_assoc=8 --l2_lat=3 --vertex_lat=3 --ruby --topology=Crossbar -c $2 -o "$3"
+			if [ ! -f $d/stats.txt ]
+			then
+				echo "$2,$3,$p,$a,$s,error" >> $out
+				continue
+			fi
+			sim=$(awk '$1 == "sim_seconds" { print $2; exit }' $d/stats.txt)
+			echo "$2,$3,$p,$a,$s,$sim,$(stat $d/stats.txt 'VertexCache[.]demand_hits$'),$(stat $d/stats.txt 'VertexCache[.]demand_misses$'),$(stat $d/stats.txt 'VertexCache[.]replacements$'),$(stat $d/stats.txt 'mem_ctrls[0-9]*[.]bytes_read::total$'),$(stat $d/stats.txt 'mem_ctrls[0-9]*[.]bytes_written::total$')" >> $out
+		done
+	done
+done
@@ -127,6 +127,26 @@ def addCommonOptions(parser):
     parser.add_option("--l1i_assoc", type="int", default=2)
     # Abraham - adding vertex cache
     parser.add_option("--vertex_assoc", type="int", default=2)
+    parser.add_option("--vertex_replacement", type="choice", default="freqcoll",
+                      choices=["freqcoll", "lfu", "pinned", "rrip"],
+                      help="replacement policy of the vertex cache")
+    parser.add_option("--vertex_aging_period", type="int", default=1024,
+                      help="lfu: touches of a set between two agings")
+    parser.add_option("--vertex_pinned_lines", type="int", default=0,
+                      help="pinned: lines of each vertex cache never replaced")
+    parser.add_option("--vertex_rrpv_bits", type="int", default=2,
+                      help="rrip: bits of the re-reference prediction value")
+    parser.add_option("--vertex_mapped_lines", type="int", default=0,
+                      help="lines mapped to each vertex cache, 0 for one per "
+                      "set, more over-commit it")
+    parser.add_option("--vertex_dest_hash", type="choice", default="block",
+                      choices=["modulo", "block", "range", "table"],
+                      help="vertex cache a vertex goes to")
+    parser.add_option("--vertex_dest_block", type="int", default=0,
+                      help="block: vertices per block, 0 for the app's "
+                      "chunk size")
+    parser.add_option("--vertex_partition_file", type="string", default="",
+                      help="table: vertex cache of each vertex, one per line")
     
     parser.add_option("--l2_assoc", type="int", default=8)
     parser.add_option("--l3_assoc", type="int", default=16)
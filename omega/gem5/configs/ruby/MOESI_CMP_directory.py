@@ -33,6 +33,7 @@ from m5.objects import *
 from m5.defines import buildEnv
 from Ruby import create_topology
 from Ruby import send_evicts
+from Ruby import create_vertex_replacement
 
 #
 # Declare caches used by the protocol
@@ -91,7 +92,13 @@ def create_system(options, full_system, system, dma_ports, ruby_system):
                             assoc = options.vertex_assoc,
                             is_icache = False,
                             is_vcache = True,
-                            numCPU = options.num_cpus
+                            numCPU = options.num_cpus,
+                            replacement_policy =
+                                create_vertex_replacement(options),
+                            mapped_lines = options.vertex_mapped_lines,
+                            dest_hash = options.vertex_dest_hash,
+                            dest_block = options.vertex_dest_block,
+                            partition_file = options.vertex_partition_file
                             )
 
         #Abraham - adding vertex cache
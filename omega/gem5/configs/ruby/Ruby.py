@@ -241,6 +241,18 @@ def create_system(options, full_system, system, piobus = None, dma_ports = []):
         ruby.phys_mem = SimpleMemory(range=system.mem_ranges[0],
                                      in_addr_map=False)
 
+# the replacement policy of the vertex cache picked by --vertex_replacement
+def create_vertex_replacement(options):
+    if options.vertex_replacement == "lfu":
+        return LFUAgingReplacementPolicy(
+            aging_period = options.vertex_aging_period)
+    if options.vertex_replacement == "pinned":
+        return DegreePinnedReplacementPolicy(
+            pinned_lines = options.vertex_pinned_lines)
+    if options.vertex_replacement == "rrip":
+        return RRIPReplacementPolicy(rrpv_bits = options.vertex_rrpv_bits)
+    return FreqCollReplacementPolicy()
+
 def send_evicts(options):
     # currently, 2 scenarios warrant forwarding evictions to the CPU:
     # 1. The O3 model must keep the LSQ coherent with the caches
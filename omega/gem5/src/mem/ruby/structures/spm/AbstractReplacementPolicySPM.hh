@@ -46,6 +46,9 @@ class AbstractReplacementPolicySPM : public SimObject
     /* touch a block. a.k.a. update timestamp */
     virtual void touch(int64_t set, int64_t way) = 0;
 
+    /* a line was allocated in the way, by default a touch */
+    virtual void insert(int64_t set, int64_t way) { touch(set, way); }
+
     /* returns the way to replace */
     virtual int64_t getVictim(int64_t set) const = 0;
 
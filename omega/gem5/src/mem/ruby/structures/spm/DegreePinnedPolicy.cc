@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2013 Advanced Micro Devices, Inc
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/structures/spm/DegreePinnedPolicy.hh"
+#include "mem/ruby/structures/spm/ScratchpadMemory.hh"
+
+
+
+DegreePinnedPolicy::DegreePinnedPolicy(const Params * p)
+    : AbstractReplacementPolicySPM(p)
+{
+    m_pinned_lines = p->pinned_lines;
+}
+
+
+DegreePinnedPolicy::~DegreePinnedPolicy()
+{
+}
+
+DegreePinnedPolicy *
+DegreePinnedReplacementPolicyParams::create()
+{
+    return new DegreePinnedPolicy(this);
+}
+
+void
+DegreePinnedPolicy::insert(int64_t set, int64_t index)
+{
+    m_freq_ref_ptr[set][index] = 1;
+}
+
+void
+DegreePinnedPolicy::touch(int64_t set, int64_t index)
+{
+    m_freq_ref_ptr[set][index] += 1;
+}
+
+//the addresses in the vertex cache are the linear indexes of the lines in
+//their home scratchpad, which grow with the vertex id
+bool
+DegreePinnedPolicy::isPinned(int64_t set, int64_t way) const
+{
+    return m_spm->getLineAddress(set, way) < m_pinned_lines;
+}
+
+int64_t
+DegreePinnedPolicy::getVictim(int64_t set) const
+{
+    //-1 if every line of the set is pinned
+    int64_t least_freq_index = -1;
+    for (unsigned i = 0; i < m_assoc; i++) {
+        if (isPinned(set, i)) {
+            continue;
+        }
+        if (least_freq_index == -1 ||
+            m_freq_ref_ptr[set][i] < m_freq_ref_ptr[set][least_freq_index]) {
+            least_freq_index = i;
+        }
+    }
+    return least_freq_index;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2013 Advanced Micro Devices, Inc
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/structures/spm/LFUAgingPolicy.hh"
+
+
+
+LFUAgingPolicy::LFUAgingPolicy(const Params * p)
+    : AbstractReplacementPolicySPM(p)
+{
+    m_max_count = p->max_count;
+    m_aging_period = p->aging_period;
+    m_set_touches = new unsigned[m_num_sets];
+    for (unsigned i = 0; i < m_num_sets; i++) {
+        m_set_touches[i] = 0;
+    }
+}
+
+
+LFUAgingPolicy::~LFUAgingPolicy()
+{
+    delete[] m_set_touches;
+}
+
+LFUAgingPolicy *
+LFUAgingReplacementPolicyParams::create()
+{
+    return new LFUAgingPolicy(this);
+}
+
+//a new line starts over, it does not inherit the count of the one it replaced
+void
+LFUAgingPolicy::insert(int64_t set, int64_t index)
+{
+    m_freq_ref_ptr[set][index] = 1;
+}
+
+void
+LFUAgingPolicy::touch(int64_t set, int64_t index)
+{
+    if (m_freq_ref_ptr[set][index] < m_max_count) {
+        m_freq_ref_ptr[set][index] += 1;
+    }
+
+    //halve the whole set, the ranking of its ways is kept
+    if (m_aging_period > 0 && ++m_set_touches[set] >= m_aging_period) {
+        for (unsigned i = 0; i < m_assoc; i++) {
+            m_freq_ref_ptr[set][i] >>= 1;
+        }
+        m_set_touches[set] = 0;
+    }
+}
+
+int64_t
+LFUAgingPolicy::getVictim(int64_t set) const
+{
+    int64_t least_freq_index = 0;
+    for (unsigned i = 1; i < m_assoc; i++) {
+        if (m_freq_ref_ptr[set][i] < m_freq_ref_ptr[set][least_freq_index]) {
+            least_freq_index = i;
+        }
+    }
+    return least_freq_index;
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2007 Mark D. Hill and David A. Wood
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_STRUCTURES_LFUAgingPOLICY_HH__
+#define __MEM_RUBY_STRUCTURES_LFUAgingPOLICY_HH__
+
+#include "mem/ruby/structures/spm/AbstractReplacementPolicySPM.hh"
+#include "params/LFUAgingReplacementPolicy.hh"
+
+/* LFU with aging: a saturating access count per way, the counts of a set
+ * are halved every aging_period touches of the set so that vertices that
+ * were hot in an earlier iteration do not stay in the scratchpad forever */
+
+class LFUAgingPolicy : public AbstractReplacementPolicySPM
+{
+  public:
+    typedef LFUAgingReplacementPolicyParams Params;
+    LFUAgingPolicy(const Params * p);
+    ~LFUAgingPolicy();
+
+    void touch(int64_t set, int64_t way);
+    void insert(int64_t set, int64_t way);
+    int64_t getVictim(int64_t set) const;
+
+  private:
+    int m_max_count;            /** saturation value of the counts */
+    unsigned m_aging_period;    /** touches of a set between two halvings */
+    unsigned *m_set_touches;    /** touches of each set since its last aging */
+};
+
+#endif // __MEM_RUBY_STRUCTURES_LFUAgingPOLICY_HH__
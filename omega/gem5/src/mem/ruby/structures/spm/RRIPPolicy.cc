@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2013 Advanced Micro Devices, Inc
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/structures/spm/RRIPPolicy.hh"
+
+
+
+RRIPPolicy::RRIPPolicy(const Params * p)
+    : AbstractReplacementPolicySPM(p)
+{
+    m_max_rrpv = (1 << p->rrpv_bits) - 1;
+    //empty ways are distant
+    for (unsigned i = 0; i < m_num_sets; i++) {
+        for (unsigned j = 0; j < m_assoc; j++) {
+            m_freq_ref_ptr[i][j] = m_max_rrpv;
+        }
+    }
+}
+
+
+RRIPPolicy::~RRIPPolicy()
+{
+}
+
+RRIPPolicy *
+RRIPReplacementPolicyParams::create()
+{
+    return new RRIPPolicy(this);
+}
+
+//new lines get a long re-reference interval, a hit makes it near
+void
+RRIPPolicy::insert(int64_t set, int64_t index)
+{
+    m_freq_ref_ptr[set][index] = m_max_rrpv - 1;
+}
+
+void
+RRIPPolicy::touch(int64_t set, int64_t index)
+{
+    m_freq_ref_ptr[set][index] = 0;
+}
+
+//ages the set until a way is distant. the scratchpad asks for the victim
+//twice per replacement (isVictimPresent and cacheProbe), the second call
+//finds the same way without aging again
+int64_t
+RRIPPolicy::getVictim(int64_t set) const
+{
+    int max_rrpv = 0;
+    int64_t victim_index = 0;
+    for (unsigned i = 0; i < m_assoc; i++) {
+        if (m_freq_ref_ptr[set][i] > max_rrpv) {
+            max_rrpv = m_freq_ref_ptr[set][i];
+            victim_index = i;
+        }
+    }
+
+    if (max_rrpv < m_max_rrpv) {
+        for (unsigned i = 0; i < m_assoc; i++) {
+            m_freq_ref_ptr[set][i] += m_max_rrpv - max_rrpv;
+        }
+    }
+    return victim_index;
+}
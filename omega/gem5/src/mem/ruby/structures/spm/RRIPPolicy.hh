@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2007 Mark D. Hill and David A. Wood
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_STRUCTURES_RRIPPOLICY_HH__
+#define __MEM_RUBY_STRUCTURES_RRIPPOLICY_HH__
+
+#include "mem/ruby/structures/spm/AbstractReplacementPolicySPM.hh"
+#include "params/RRIPReplacementPolicy.hh"
+
+/* Static RRIP (Jaleel et al., ISCA 2010): a re-reference prediction value
+ * per way, kept in m_freq_ref_ptr. Lines are inserted with a long re-reference
+ * interval and promoted to near on a hit, so the many vertices touched once
+ * per iteration do not push out the ones that are reused. */
+
+class RRIPPolicy : public AbstractReplacementPolicySPM
+{
+  public:
+    typedef RRIPReplacementPolicyParams Params;
+    RRIPPolicy(const Params * p);
+    ~RRIPPolicy();
+
+    void touch(int64_t set, int64_t way);
+    void insert(int64_t set, int64_t way);
+    int64_t getVictim(int64_t set) const;
+
+  private:
+    int m_max_rrpv;             /** distant re-reference, 2^rrpv_bits - 1 */
+};
+
+#endif // __MEM_RUBY_STRUCTURES_RRIPPOLICY_HH__
@@ -5,10 +5,10 @@
 # Redistribution and use in source and binary forms, with or without
 # modification, are permitted provided that the following conditions are
 # met: redistributions of source code must retain the above copyright
-# notice, this list of conditions and the following disclaimer;
+# notice, this list of conditions and the following disclaimer
 # redistributions in binary form must reproduce the above copyright
 # notice, this list of conditions and the following disclaimer in the
-# documentation and/or other materials provided with the distribution;
+# documentation and/or other materials provided with the distribution
 # neither the name of the copyright holders nor the names of its
 # contributors may be used to endorse or promote products derived from
 # this software without specific prior written permission.
@@ -41,3 +41,27 @@ class ReplacementPolicySPM(SimObject):
     size = Param.MemorySize(Parent.size, "capacity in bytes")
 
     assoc = Param.Int(Parent.assoc, "associativity")
+
+class LFUAgingReplacementPolicy(ReplacementPolicySPM):
+    type = 'LFUAgingReplacementPolicy'
+    cxx_class = 'LFUAgingPolicy'
+    cxx_header = 'mem/ruby/structures/spm/LFUAgingPolicy.hh'
+
+    max_count = Param.Int(255, "saturation value of the access counts")
+    aging_period = Param.Unsigned(1024, "touches of a set between two " +
+                   "halvings of its counts, 0 never ages")
+
+class DegreePinnedReplacementPolicy(ReplacementPolicySPM):
+    type = 'DegreePinnedReplacementPolicy'
+    cxx_class = 'DegreePinnedPolicy'
+    cxx_header = 'mem/ruby/structures/spm/DegreePinnedPolicy.hh'
+
+    pinned_lines = Param.Addr(0, "lines below this index of each scratchpad " +
+                   "(the hubs of a hub-first ordering) are never replaced")
+
+class RRIPReplacementPolicy(ReplacementPolicySPM):
+    type = 'RRIPReplacementPolicy'
+    cxx_class = 'RRIPPolicy'
+    cxx_header = 'mem/ruby/structures/spm/RRIPPolicy.hh'
+
+    rrpv_bits = Param.Int(2, "bits of the re-reference prediction value")
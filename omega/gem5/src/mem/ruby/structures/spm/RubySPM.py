@@ -70,6 +70,28 @@ class RubySPM(SimObject):
  
 
     numCPU = Param.Unsigned(1, "Number of cores")
+
+    mapped_lines = Param.Int(0, "lines of vertex data mapped to each " +
+                   "scratchpad, 0 for one per set. More lines than it holds " +
+                   "over-commit it: a full set replaces the line the " +
+                   "replacement_policy picks and its value is dropped, so " +
+                   "this is for replacement and traffic studies only")
+
+    dest_hash = Param.String("block", "scratchpad a vertex goes to: " +
+                   "modulo (vertex % numCPU), block (blocks of dest_block " +
+                   "vertices round robin), range (numCPU contiguous ranges " +
+                   "of the mapped vertices) or table (partition_file)")
+    dest_block = Param.Unsigned(0, "vertices per block of the block hash, " +
+                   "0 for the chunk size the app writes")
+    partition_file = Param.String("", "scratchpad of each vertex, one per " +
+                   "line in the order of the vertex ids, for the table hash")
+
+    vertex_range_buckets = Param.Unsigned(32, "ranges of vertex ids the " +
+                   "vertex_range_hits/misses stats are split into")
+    pisc_sample_period = Param.Cycles(10000, "cycles per sample of the " +
+                   "PISC queue occupancy series")
+    pisc_series_length = Param.Unsigned(128, "samples of the PISC queue " +
+                   "occupancy series, the last one takes the rest of the run")
     
     dataArrayBanks = Param.Int(1, "Number of banks for the data array")
     tagArrayBanks = Param.Int(1, "Number of banks for the tag array")
@@ -36,6 +36,8 @@
 #include "mem/ruby/structures/spm/ScratchpadMemory.hh"
 #include "mem/ruby/system/RubySystem.hh"
 #include <limits.h>
+#include <algorithm>
+#include <fstream>
 #include "sim/system.hh"
 
 using namespace std;
@@ -82,6 +84,24 @@ ScratchpadMemory::ScratchpadMemory(const Params *p)
         m_numCPU = p->numCPU;
            
         m_block_size = p->block_size;
+        m_mapped_lines = p->mapped_lines;
+        m_ruby_system = p->ruby_system;
+        m_vertex_range_buckets = p->vertex_range_buckets;
+        m_pisc_sample_period = p->pisc_sample_period;
+        m_pisc_series_length = p->pisc_series_length;
+        if (p->dest_hash == "modulo")
+            m_dest_hash = 'm';
+        else if (p->dest_hash == "block")
+            m_dest_hash = 'b';
+        else if (p->dest_hash == "range")
+            m_dest_hash = 'r';
+        else if (p->dest_hash == "table")
+            m_dest_hash = 't';
+        else
+            fatal("%s: unknown dest_hash %s, expected modulo, block, range "
+                  "or table\n", name(), p->dest_hash);
+        m_dest_block = p->dest_block;
+        m_partition_file = p->partition_file;
         //setting default value from parameters
         hashType = 'm'; //p->defaultHashType;
         oppType = 'i'; //p->defaultOppType;
@@ -111,6 +131,9 @@ ScratchpadMemory::ScratchpadMemory(const Params *p)
         }
         
         numAccelCompleted = 0; 
+        
+        if (m_dest_hash == 't')
+            loadPartition();
        
         
         DPRINTF(RubySPM, "number of lines: %i\n", m_spm_num_sets); 
@@ -175,8 +198,106 @@ ScratchpadMemory::ScratchpadMemory(const Params *p)
     int 
     ScratchpadMemory::hashDest(Addr addr)
     {
-        DPRINTF(RubySPM, "m_numCPU: %i dest: %i", m_numCPU, addr % m_numCPU); 
-        return (addr % m_numCPU); 
+        int dest;
+        switch (m_dest_hash) {
+          case 'b':
+            dest = (addr / destBlock()) % m_numCPU;
+            break;
+          case 'r':
+            dest = std::min(addr / destRange(), (Addr)(m_numCPU - 1));
+            break;
+          case 't':
+            fatal_if(addr >= m_partition.size(), "%s: vertex %d is not in "
+                     "the %d vertices of %s\n", name(), addr,
+                     m_partition.size(), m_partition_file);
+            dest = m_partition[addr];
+            break;
+          default:
+            dest = addr % m_numCPU;
+            break;
+        }
+        DPRINTF(RubySPM, "m_numCPU: %i vertex: %i dest: %i\n", m_numCPU, addr, dest); 
+        return dest; 
+    }
+
+    /**
+     * The line of a vertex in the scratchpad hashDest sends it to: the
+     * vertices of a scratchpad take its lines in the order of their ids.
+     */
+    Addr
+    ScratchpadMemory::hashLine(Addr addr)
+    {
+        switch (m_dest_hash) {
+          case 'b': {
+            Addr block = destBlock();
+            return ((addr / block) / m_numCPU) * block + (addr % block);
+          }
+          case 'r':
+            return addr - hashDest(addr) * destRange();
+          case 't':
+            hashDest(addr);
+            return m_partition_line[addr];
+          default:
+            return addr / m_numCPU;
+        }
+    }
+
+    /**
+     * Vertices per block of the block hash, the chunk size the app wrote
+     * unless dest_block is set.
+     */
+    Addr
+    ScratchpadMemory::destBlock() const
+    {
+        Addr block = (m_dest_block > 0) ? m_dest_block : system->chunkSize;
+        return (block > 0) ? block : 1;
+    }
+
+    /**
+     * Vertices per scratchpad of the range hash: the mapped vertices split
+     * into m_numCPU contiguous ranges.
+     */
+    Addr
+    ScratchpadMemory::destRange() const
+    {
+        Addr mapped = (Addr)getNumMappedLines() * m_numCPU;
+        if (system->numVertex > 0 && (Addr)system->numVertex < mapped)
+            mapped = system->numVertex;
+        return std::max(divCeil(mapped, (Addr)m_numCPU), (Addr)1);
+    }
+
+    /**
+     * Reads the partition of the table hash, one scratchpad per line for
+     * the vertices in the order of their ids, e.g. the communities of the
+     * order the graph was relabeled with. A scratchpad holding more
+     * vertices than its lines over-commits it as mapped_lines does.
+     */
+    void
+    ScratchpadMemory::loadPartition()
+    {
+        std::ifstream in(m_partition_file.c_str());
+        fatal_if(!in, "%s: cannot open partition_file %s\n", name(),
+                 m_partition_file);
+
+        std::vector<Addr> count(m_numCPU, 0);
+        long dest;
+        while (in >> dest) {
+            fatal_if(dest < 0 || dest >= m_numCPU, "%s: scratchpad %d of "
+                     "vertex %d in %s is not below numCPU %d\n", name(),
+                     dest, m_partition.size(), m_partition_file, m_numCPU);
+            m_partition.push_back(dest);
+            m_partition_line.push_back(count[dest]++);
+        }
+        fatal_if(!in.eof(), "%s: %s has something other than a scratchpad "
+                 "on line %d\n", name(), m_partition_file,
+                 m_partition.size() + 1);
+
+        for (int i = 0; i < m_numCPU; i++) {
+            if (count[i] > (Addr)getNumMappedLines())
+                warn("%s: %d vertices of %s go to scratchpad %d, which maps "
+                     "%d lines\n", name(), count[i], m_partition_file, i,
+                     getNumMappedLines());
+        }
     }
 
     /**
@@ -194,9 +315,10 @@ ScratchpadMemory::ScratchpadMemory(const Params *p)
         DPRINTF(RubySPM, "m_numCPU: %i line address: %i number of lines: %i\n", m_numCPU, (addr), m_spm_num_sets); 
         //not m_numCPU rather the amount of bits for representing this value 
         //return ((addr >> m_numCPU) %  m_spm_num_sets);
-        //return ((addr ) %  m_spm_num_sets);
         //return (addr / m_numCPU);
-        return (addr);
+        //the same as addr unless mapped_lines over-commits the scratchpad,
+        //the extra lines then wrap onto the data sets, never the chunk scheduling ones
+        return ((addr ) %  getNumSets());
 }
 
 /**
@@ -1254,17 +1376,24 @@ ScratchpadMemory::atomicExecution(PacketPtr pkt, DataBlock& blk, int offset)
             break;
     };
 }
+//cycles the PISC takes for an op
+int
+ScratchpadMemory::opLatency(char op) const {
+    int latency = 0;
+    for (auto i = latency_per_app.begin(); i != latency_per_app.end(); ++i) {
+        if (i->first == op) {
+            latency = i->second;
+        }
+    }
+    return latency;
+}
+
 // Abraham - mrnitro - adding source & destination scratchpads
 Cycles
 ScratchpadMemory::getAtomicOverhead() {
     int v_response_latency =2; //default value set in MESI protocol
     //int atomicOppType = (int)(system->atomicOppType1) - 48;
-   int latency=0; 
-    for (auto i = latency_per_app.begin(); i != latency_per_app.end(); ++i) {
-                    if (i->first == system->atomicOppType1) {
-                        latency =  Cycles(i->second); 
-                    }
-                }
+   int latency = opLatency(system->atomicOppType1);
     
    DPRINTF(RubySPM, "Latency for atomic %i\n", Cycles( v_response_latency + latency));
             
@@ -1272,6 +1401,78 @@ ScratchpadMemory::getAtomicOverhead() {
 
 }
 
+//the element of the mapped arrays the packet goes to, as the Sequencer maps
+//them: vertexStartAddr + vertex * stride for the tracked arrays
+int
+ScratchpadMemory::vertexOf(PacketPtr pkt) const
+{
+    Addr starts[3] = {system->vertexStartAddr1, system->vertexStartAddr2,
+                      system->vertexStartAddr3};
+    Addr enabled[3] = {system->enableTrackedAddr1, system->enableTrackedAddr2,
+                       system->enableTrackedAddr3};
+    int strides[3] = {system->stride1, system->stride2, system->stride3};
+
+    if (pkt == NULL) {
+        return -1;
+    }
+    Addr vaddr = pkt->getVaddr();
+    for (int i = 0; i < 3; i++) {
+        if (enabled[i] == 1 && vaddr >= starts[i] && strides[i] > 0 &&
+            (vaddr - starts[i]) / strides[i] < system->numVertex) {
+            return (vaddr - starts[i]) / strides[i];
+        }
+    }
+    return -1;
+}
+
+void
+ScratchpadMemory::recordVertexAccess(PacketPtr pkt, bool hit)
+{
+    int vertex = vertexOf(pkt);
+    if (vertex < 0) {
+        return;
+    }
+    int range = (uint64_t)vertex * m_vertex_range_buckets / system->numVertex;
+    if (hit) {
+        m_vertex_range_hits[range]++;
+    } else {
+        m_vertex_range_misses[range]++;
+    }
+}
+
+//the PISC executes one op at a time in arrival order, an op waits for the
+//ones ahead of it. the response latency the protocol charges is unchanged,
+//this only measures how the ops pile up
+void
+ScratchpadMemory::recordPISC(PacketPtr pkt)
+{
+    Tick now = curTick();
+    while (!m_pisc_done.empty() && m_pisc_done.front() <= now) {
+        m_pisc_done.pop_front();
+    }
+    int occupancy = m_pisc_done.size();
+
+    char op = pkt->getAtomicOppType();
+    Tick start = m_pisc_done.empty() ? now : m_pisc_done.back();
+    Tick done = start + m_ruby_system->cyclesToTicks(Cycles(opLatency(op)));
+    m_pisc_done.push_back(done);
+
+    if (op >= 'd' && op <= 'j') {
+        m_pisc_ops[op - 'd']++;
+        m_pisc_latency[op - 'd'].sample(
+            (done - now) / m_ruby_system->clockPeriod());
+    }
+    m_pisc_occupancy.sample(occupancy);
+
+    uint64_t sample = uint64_t(m_ruby_system->curCycle()) /
+        uint64_t(m_pisc_sample_period);
+    if (sample >= m_pisc_series_length) {
+        sample = m_pisc_series_length - 1;
+    }
+    m_pisc_occupancy_series[sample] += occupancy;
+    m_pisc_arrival_series[sample]++;
+}
+
 // Abraham - mrnitro - adding source & destination scratchpads
 //write key-value pairs to scratchpad after receiving from the core 
 void
@@ -1283,6 +1484,7 @@ ScratchpadMemory::setDataSPM(PacketPtr pkt, DataBlock& blk, int offset, bool isA
     
     if (isAtomic) {
         DPRINTF(RubySPM, " Atomic call: remote  pkt value: %x pkt_value_1_byte %x addr: %x offset: %i\n", (uint64_t)*(pkt->getConstPtr<uint64_t>()), (uint8_t)*(pkt->getConstPtr<uint8_t>()), pkt->getVaddr() , offset);
+        recordPISC(pkt);
         atomicExecution(pkt, blk, offset);
     }
     else {
@@ -1575,7 +1777,7 @@ ScratchpadMemory::allocate(Addr address, AbstractCacheEntry *entry, bool touch)
             entry->setWayIndex(i);
 
             if (touch) {
-                m_replacementPolicy_ptr->touch(cacheSet, i);
+                m_replacementPolicy_ptr->insert(cacheSet, i);
             }
 
             return entry;
@@ -1777,6 +1979,11 @@ ScratchpadMemory::regStats()
         .desc("Number of cache demand misses")
         ;
 
+    m_replacements
+        .name(name() + ".replacements")
+        .desc("Number of lines replaced by the replacement policy")
+        ;
+
     m_demand_accesses
         .name(name() + ".demand_accesses")
         .desc("Number of cache demand accesses")
@@ -1784,6 +1991,89 @@ ScratchpadMemory::regStats()
 
     m_demand_accesses = m_demand_hits + m_demand_misses;
 
+    m_vertex_range_hits
+        .init(m_vertex_range_buckets)
+        .name(name() + ".vertex_range_hits")
+        .desc("Number of demand hits per range of vertex ids")
+        .flags(Stats::total | Stats::nozero)
+        ;
+
+    m_vertex_range_misses
+        .init(m_vertex_range_buckets)
+        .name(name() + ".vertex_range_misses")
+        .desc("Number of demand misses per range of vertex ids")
+        .flags(Stats::total | Stats::nozero)
+        ;
+
+    m_vertex_range_miss_rate
+        .name(name() + ".vertex_range_miss_rate")
+        .desc("Demand miss rate per range of vertex ids")
+        .flags(Stats::nozero)
+        ;
+
+    m_vertex_range_miss_rate = m_vertex_range_misses /
+        (m_vertex_range_hits + m_vertex_range_misses);
+
+    //range i holds the vertices [i, i + 1) * numVertex / buckets
+    for (unsigned i = 0; i < m_vertex_range_buckets; i++) {
+        std::string range = "r" + std::to_string(i);
+        m_vertex_range_hits.subname(i, range);
+        m_vertex_range_misses.subname(i, range);
+        m_vertex_range_miss_rate.subname(i, range);
+    }
+
+    m_pisc_ops
+        .init(7)
+        .name(name() + ".pisc_ops")
+        .desc("Number of atomic ops executed by the PISC, per op type")
+        .flags(Stats::total | Stats::nozero)
+        ;
+
+    m_pisc_latency
+        .init(7, 0, 255, 4)
+        .name(name() + ".pisc_latency")
+        .desc("Cycles from the arrival of an op at the PISC to its "
+              "completion, per op type")
+        .flags(Stats::nozero)
+        ;
+
+    for (int i = 0; i < 7; i++) {
+        std::string op(1, 'd' + i);
+        m_pisc_ops.subname(i, op);
+        m_pisc_latency.subname(i, op);
+    }
+
+    m_pisc_occupancy
+        .init(0, 63, 1)
+        .name(name() + ".pisc_occupancy")
+        .desc("Ops queued at the PISC when an op arrives")
+        .flags(Stats::nozero)
+        ;
+
+    m_pisc_occupancy_series
+        .init(m_pisc_series_length)
+        .name(name() + ".pisc_occupancy_series")
+        .desc("Sum of the PISC queue occupancies seen by the arrivals, "
+              "per pisc_sample_period cycles")
+        .flags(Stats::nozero)
+        ;
+
+    m_pisc_arrival_series
+        .init(m_pisc_series_length)
+        .name(name() + ".pisc_arrival_series")
+        .desc("Ops arriving at the PISC per pisc_sample_period cycles")
+        .flags(Stats::nozero)
+        ;
+
+    m_pisc_mean_occupancy_series
+        .name(name() + ".pisc_mean_occupancy_series")
+        .desc("Mean PISC queue occupancy per pisc_sample_period cycles")
+        .flags(Stats::nozero)
+        ;
+
+    m_pisc_mean_occupancy_series = m_pisc_occupancy_series /
+        m_pisc_arrival_series;
+
     m_sw_prefetches
         .name(name() + ".total_sw_prefetches")
         .desc("Number of software prefetches")
@@ -1930,6 +2220,13 @@ ScratchpadMemory::isBlockNotBusy(int64_t cache_set, int64_t loc)
   return (m_spm[cache_set][loc]->m_Permission != AccessPermission_Busy);
 }
 
+Addr
+ScratchpadMemory::getLineAddress(int64_t cache_set, int64_t loc) const
+{
+  AbstractCacheEntry* entry = m_spm[cache_set][loc];
+  return (entry == NULL) ? 0 : entry->m_Address;
+}
+
 //Abraham - adding source & destination scratchpads
 //several set functions specific to the scratchpad implementations
 void 
@@ -2056,6 +2353,13 @@ ScratchpadMemory::getNumSets() const
     return (m_spm_num_sets - maxChunkSize) ; //Abraham - substracting to account for chunk based scheduling
 }
 
+//lines of each scratchpad the Sequencer maps the vertex data to
+int
+ScratchpadMemory::getNumMappedLines() const
+{
+    return (m_mapped_lines > 0) ? m_mapped_lines : getNumSets();
+}
+
 int
 ScratchpadMemory::getNumEntries() const 
 {
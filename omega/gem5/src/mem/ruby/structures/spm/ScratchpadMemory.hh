@@ -30,6 +30,7 @@
 #ifndef __MEM_RUBY_STRUCTURES_SPM_HH__
 #define __MEM_RUBY_STRUCTURES_SPM_HH__
 
+#include <deque>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -79,7 +80,9 @@ class ScratchpadMemory : public SimObject
     void setSparseActiveVertex(PacketPtr pkt, uint8_t success);
     
     int maxNumAccel();
+    // home scratchpad of a vertex, and its line there, by dest_hash
     int hashDest(Addr addr);
+    Addr hashLine(Addr addr);
 
     // Returns true if there is:
     //   a) a tag match on this address or there is
@@ -117,6 +120,9 @@ class ScratchpadMemory : public SimObject
 
     bool isBlockInvalid(int64_t cache_set, int64_t loc);
     bool isBlockNotBusy(int64_t cache_set, int64_t loc);
+    // the address in a way whatever its permission (the vertex lines stay
+    // Invalid), 0 for an empty way
+    Addr getLineAddress(int64_t cache_set, int64_t loc) const;
 
     // Hook for checkpointing the contents of the cache
     void recordCacheContents(int cntrl, CacheRecorder* tr) const;
@@ -168,6 +174,7 @@ class ScratchpadMemory : public SimObject
     int getNumAccelCompleted () const;
     int getNumAssoc () const;
     int getNumSets () const;
+    int getNumMappedLines () const;
     int getNumEntries () const;
 
 
@@ -203,8 +210,22 @@ class ScratchpadMemory : public SimObject
     Stats::Scalar m_atomic_execution;
     Stats::Scalar m_demand_hits;
     Stats::Scalar m_demand_misses;
+    Stats::Scalar m_replacements;
     Stats::Formula m_demand_accesses;
 
+    // hits and misses per range of vertex ids
+    Stats::Vector m_vertex_range_hits;
+    Stats::Vector m_vertex_range_misses;
+    Stats::Formula m_vertex_range_miss_rate;
+
+    // PISC ops 'd'-'j', their latency through the PISC and its queue
+    Stats::Vector m_pisc_ops;
+    Stats::VectorDistribution m_pisc_latency;
+    Stats::Distribution m_pisc_occupancy;
+    Stats::Vector m_pisc_occupancy_series;
+    Stats::Vector m_pisc_arrival_series;
+    Stats::Formula m_pisc_mean_occupancy_series;
+
     Stats::Scalar m_sw_prefetches;
     Stats::Scalar m_hw_prefetches;
     Stats::Formula m_prefetches;
@@ -224,6 +245,11 @@ class ScratchpadMemory : public SimObject
     Addr getAddressAtIdx(int idx) const;
 
     Cycles getAtomicOverhead();
+
+    // count a demand access in the range of its vertex
+    void recordVertexAccess(PacketPtr pkt, bool hit);
+    // an atomic op arrives at the PISC
+    void recordPISC(PacketPtr pkt);
     
     //Abraham - adding source & destination scratchpads
     //identify if this object is of type sspm or dspm
@@ -291,6 +317,31 @@ class ScratchpadMemory : public SimObject
     Addr m_needSecHashingAddr;
     int m_numCPU;
     int m_block_size;
+    int m_mapped_lines;
+
+    // hashDest: m - modulo, b - block interleaved, r - range partitioned,
+    // t - partition_file
+    char m_dest_hash;
+    unsigned m_dest_block;
+    std::string m_partition_file;
+    // scratchpad and line of each vertex of the partition_file
+    std::vector<int> m_partition;
+    std::vector<Addr> m_partition_line;
+    Addr destBlock() const;
+    Addr destRange() const;
+    void loadPartition();
+
+    // the vertex of a packet to the mapped arrays, -1 for other addresses
+    int vertexOf(PacketPtr pkt) const;
+    // cycles of an op in latency_per_app
+    int opLatency(char op) const;
+
+    RubySystem *m_ruby_system;
+    unsigned m_vertex_range_buckets;
+    Cycles m_pisc_sample_period;
+    unsigned m_pisc_series_length;
+    // completion ticks of the ops in the PISC, oldest first
+    std::deque<Tick> m_pisc_done;
     //identify what kind of memory this object is  
     bool m_is_instruction_only_cache;
     
@@ -1752,7 +1752,7 @@ Sequencer::makeRequest(PacketPtr pkt)
         else if (pkt->getVaddr() == configNumMappedVertices) {
             //copy the value  
             
-            unsigned int numSpdSets = m_vertexCache_ptr->getNumSets();
+            unsigned int numSpdSets = m_vertexCache_ptr->getNumMappedLines();
             unsigned int numSpdLinesMapped = numSpdSets*m_numCPU;
 
             memcpy(pkt->getPtr<uint8_t>(), &numSpdLinesMapped, pkt->getSize());
@@ -2241,7 +2241,7 @@ Sequencer::makeRequest(PacketPtr pkt)
 bool
 Sequencer::isVertexInAddrRange(PacketPtr pkt, int addrRange) {
 
-    int numSpdSets = m_vertexCache_ptr->getNumSets();
+    int numSpdSets = m_vertexCache_ptr->getNumMappedLines();
     int numLinesMapped = (system->numVertex > numSpdSets*m_numCPU) ? numSpdSets*m_numCPU : system->numVertex;
     //DPRINTF(RubySequencer, "Details of spec. system->numVertex: %i numSpdSets: %i numLinesMapped: %i system->stride1: %i  stride2: %i system->dataTypeSize1: %i system->dataTypeSize2: %i system->dataTypeSize3: %i\n", 
     //        system->numVertex, numSpdSets, numLinesMapped, system->stride1, stride2, system->dataTypeSize1, system->dataTypeSize2, system->dataTypeSize3);
@@ -2332,21 +2332,21 @@ Sequencer::isOutEdgeLocal(PacketPtr pkt)
     unsigned int vertexId = (unsigned int)*(pkt->getConstPtr<uint64_t>());
     //most probably it is in range 3 
     if (isEdgeInAddrRange(pkt, 3)) {
-        if (((vertexId) % m_numCPU) == pkt->req->contextId())
+        if (destSPM(vertexId) == pkt->req->contextId())
             return true;
     }
     else if (isEdgeInAddrRange(pkt, 1)) {
         DPRINTF(RubySequencer, "pkt is in addre range 1\n");
-        if (((vertexId) % m_numCPU) == pkt->req->contextId())
+        if (destSPM(vertexId) == pkt->req->contextId())
             return true;
     }
     else if (isEdgeInAddrRange(pkt, 2)) {
-        if (((vertexId) % m_numCPU) == pkt->req->contextId())
+        if (destSPM(vertexId) == pkt->req->contextId())
             return true;
     }
 
     else if (isEdgeInAddrRange(pkt, 4)) {
-        if (((vertexId) % m_numCPU) == pkt->req->contextId())
+        if (destSPM(vertexId) == pkt->req->contextId())
             return true;
     }
     else
@@ -2393,13 +2393,13 @@ Sequencer::setEntry(unsigned int vertexId) {
     
     DPRINTF(RubySequencer, "system->chunkSize%#u system->numVertex %#x vertexId %#x\n", system->chunkSize, system->numVertex, vertexId);
     
-    return ((((vertexId/system->chunkSize)/m_numCPU)*system->chunkSize) + (vertexId%system->chunkSize));
+    return m_vertexCache_ptr->hashLine(vertexId);
 }
 
 unsigned  
 Sequencer::destSPM(unsigned int vertexId) {
     
-    return (vertexId/system->chunkSize)%m_numCPU;
+    return m_vertexCache_ptr->hashDest(vertexId);
 
 }
 
@@ -8,18 +8,16 @@ input=~/materials/sample_edgelists/filtered
 output=~/workloads/datasets
 variants=(weighted unweighted)
 rmvr() {
-	rm new_order.el
+	rm -f new_order.el
 }
 function ph() {
 	for i in  "${graphs[@]}"; do
 		elloc="${i}.el"
 		welloc="${i}.wel"
-		python3 ph/ph.py -p=ph/ph $input/$elloc $output/unweighted/ph/$elloc; rmvr;
-		python3 ph/ph.py -m -p=ph/ph $input/$elloc $output/unweighted/ph/maintained/$elloc; rmvr;
-		python3 ph/ph.py -m -w -p=ph/ph $input/$welloc $output/weighted/ph/$welloc; rmvr;
-		./converter -f $output/unweighted/ph/$elloc -b $output/unweighted/ph/${i}.sg;
-		./converter -f $output/weighted/ph/$welloc -w -b $output/weighted/ph/${i}.wsg;
-		./converter -f $output/unweighted/ph/maintained/$elloc -b $output/unweighted/ph/maintained/${i}.sg
+		# .sg / .wsg outputs are written directly, no edge list for the converter
+		./graphReordering/pH/ph 532480 $input/$elloc $output/unweighted/ph/${i}.sg; rmvr;
+		./graphReordering/pH/ph 532480 -m $input/$elloc $output/unweighted/ph/maintained/${i}.sg; rmvr;
+		./graphReordering/pH/ph 532480 -m -w $input/$welloc $output/weighted/ph/${i}.wsg; rmvr;
 	done
 }
 #br reorder
@@ -27,24 +25,18 @@ function br (){
 	for i in "${graphs[@]}"; do
 		elloc="${i}.el";
 		welloc="${i}.wel";
-		python3 br/br.py -p=br/br $input/$elloc $output/unweighted/br/$elloc; rmvr;
-		python3 br/br.py -m -p=br/br $input/$elloc $output/unweighted/br/maintained/$elloc; rmvr;
-		python3 br/br.py -m -w -p=br/br $input/$welloc $output/weighted/br/$welloc; rmvr;
-		./converter -f $output/unweighted/br/$elloc -b $output/unweighted/br/${i}.sg;
-		./converter -f $output/unweighted/br/maintained/$elloc -b $output/unweighted/br/maintained/${i}.sg;
-		./converter -f $output/weighted/br/$welloc -w -b $output/weighted/br/${i}.wsg;
+		./graphReordering/block_reordering/br 64 532480 $input/$elloc $output/unweighted/br/${i}.sg; rmvr;
+		./graphReordering/block_reordering/br 64 532480 -m $input/$elloc $output/unweighted/br/maintained/${i}.sg; rmvr;
+		./graphReordering/block_reordering/br 64 532480 -m -w $input/$welloc $output/weighted/br/${i}.wsg; rmvr;
 	done
 }
 function rabbit() {
 	for i in "${graphs[@]}"; do
 		elloc="${i}.el"
 		welloc="${i}.wel"
-		python3 rabbit/rabbit.py $input/$elloc $output/unweighted/rabbit/$elloc; rmvr;
-		python3 rabbit/rabbit.py -m $input/$elloc $output/unweighted/rabbit/maintained/$elloc; rmvr;
-		python3 rabbit/rabbit.py -m -w $input/$welloc $output/weighted/rabbit/$welloc; rmvr;
-		./converter -f $output/unweighted/rabbit/$elloc -b $output/unweighted/rabbit/${i}.sg;
-		./converter -f $output/unweighted/rabbit/maintained/$elloc -b $output/unweighted/rabbit/maintained/${i}.sg
-		./converter -f $output/weighted/rabbit/$welloc -w -b $output/weighted/rabbit/${i}.wsg;
+		rabbit/reorder $input/$elloc | ./graphReordering/relabel/relabel - $input/$elloc $output/unweighted/rabbit/${i}.sg; rmvr;
+		rabbit/reorder $input/$elloc | ./graphReordering/relabel/relabel -m - $input/$elloc $output/unweighted/rabbit/maintained/${i}.sg; rmvr;
+		awk '{print $1, $2}' $input/$welloc > input.el; rabbit/reorder input.el | ./graphReordering/relabel/relabel -m -w - $input/$welloc $output/weighted/rabbit/${i}.wsg; rm -f input.el;
 	done
 }
 #Gorder reordering
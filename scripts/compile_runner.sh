@@ -10,3 +10,10 @@ for a in "${apps[@]}"; do
 		g++ -std=c++14 -I ../../src/runtime_lib/ -O3 -DOPENMP -fopenmp ${a}_benchmark_${d}.cpp graphit_apps/logger.cpp -o ${path}multi/$d/$a;
 	done
 done
+# the host runs every app with both schedules on one load of each graph (graphit_apps/host)
+for a in "${apps[@]}"; do
+	for d in "${directions[@]}"; do
+		python3 graphitc.py -f ~/materials/graphit_schedules/${d}.gt -a graphit_apps/host/${a}_export.gt -o graphit_apps/host/${a}_${d}.cpp;
+	done
+done
+g++ -std=c++14 -I ../../src/runtime_lib/ -O3 -DOPENMP -fopenmp graphit_apps/host/main.cpp graphit_apps/logger.cpp -o ${path}host
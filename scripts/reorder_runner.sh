@@ -30,14 +30,14 @@ function cl () {
 	for i in "${graphs[@]}"; do
 		welloc="${i}.wel"
 		elloc="${i}.el"
-		python3 cluster/hub.py -m -w -s ~/materials/sample_edgelists/$welloc ~/workloads/datasets/weighted/cl/sort/outdegree$welloc;
-		python3 cluster/hub.py  -m -w -i -s ~/materials/sample_edgelists/$welloc ~/workloads/datasets/weighted/cl/sort/indegree$welloc;
-		python3 cluster/hub.py -m -w ~/materials/sample_edgelists/$welloc ~/workloads/datasets/weighted/cl/cluster/outdegree/$welloc;
-		python3 cluster/hub.py -m -w -i ~/materials/sample_edgelists/$welloc ~/workloads/datasets/weighted/cl/cluster/indegree/$welloc;
-		python3 cluster/hub.py -m -s ~/materials/sample_edgelists/${elloc} ~/workloads/datasets/unweighted/cl/sort/outdegree${elloc};
-		python3 cluster/hub.py  -m -i -s ~/materials/sample_edgelists/${elloc} ~/workloads/datasets/unweighted/cl/sort/indegree${elloc};
-		python3 cluster/hub.py -m ~/materials/sample_edgelists/${elloc} ~/workloads/datasets/unweighted/cl/cluster/outdegree/${elloc};
-		python3 cluster/hub.py -m -i ~/materials/sample_edgelists/${elloc} ~/workloads/datasets/unweighted/cl/cluster/indegree/${elloc};
+		./graphReordering/degree/deg --hub -m -w -s ~/materials/sample_edgelists/$welloc ~/workloads/datasets/weighted/cl/sort/outdegree$welloc;
+		./graphReordering/degree/deg --hub  -m -w -i -s ~/materials/sample_edgelists/$welloc ~/workloads/datasets/weighted/cl/sort/indegree$welloc;
+		./graphReordering/degree/deg --hub -m -w ~/materials/sample_edgelists/$welloc ~/workloads/datasets/weighted/cl/cluster/outdegree/$welloc;
+		./graphReordering/degree/deg --hub -m -w -i ~/materials/sample_edgelists/$welloc ~/workloads/datasets/weighted/cl/cluster/indegree/$welloc;
+		./graphReordering/degree/deg --hub -m -s ~/materials/sample_edgelists/${elloc} ~/workloads/datasets/unweighted/cl/sort/outdegree${elloc};
+		./graphReordering/degree/deg --hub  -m -i -s ~/materials/sample_edgelists/${elloc} ~/workloads/datasets/unweighted/cl/sort/indegree${elloc};
+		./graphReordering/degree/deg --hub -m ~/materials/sample_edgelists/${elloc} ~/workloads/datasets/unweighted/cl/cluster/outdegree/${elloc};
+		./graphReordering/degree/deg --hub -m -i ~/materials/sample_edgelists/${elloc} ~/workloads/datasets/unweighted/cl/cluster/indegree/${elloc};
 	done
 }
 #deg reorder
@@ -45,10 +45,10 @@ function deg() {
 	for i in "${graphs[@]}"; do
 		welloc="${i}.wel"
 		elloc="${i}.el"
-		python3 degree/degree.py -m -w ~/materials/sample_edgelists/$welloc ~/workloads/datasets/weighted/deg/outdegree/$welloc;
-		python3 degree/degree.py -m -w -i ~/materials/sample_edgelists/$welloc ~/workloads/datasets/weighted/deg/indegree/$welloc;
-		python3 degree/degree.py -m ~/materials/sample_edgelists/${elloc} ~/workloads/datasets/unweighted/deg/outdegree/${elloc};
-		python3 degree/degree.py -m -i ~/materials/sample_edgelists/${elloc} ~/workloads/datasets/unweighted/deg/indegree/${elloc};
+		./graphReordering/degree/deg -m -w ~/materials/sample_edgelists/$welloc ~/workloads/datasets/weighted/deg/outdegree/$welloc;
+		./graphReordering/degree/deg -m -w -i ~/materials/sample_edgelists/$welloc ~/workloads/datasets/weighted/deg/indegree/$welloc;
+		./graphReordering/degree/deg -m ~/materials/sample_edgelists/${elloc} ~/workloads/datasets/unweighted/deg/outdegree/${elloc};
+		./graphReordering/degree/deg -m -i ~/materials/sample_edgelists/${elloc} ~/workloads/datasets/unweighted/deg/indegree/${elloc};
 	done
 }
 br